@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# benchcmp.py
+# Runs on the development computer
+# Compares two captures of the OS_BENCH output (Lab4_Fitness_4C123/Bench.c)
+# and flags measurements whose median grew by more than a threshold.
+# October 19, 2026
+#
+#   python3 benchcmp.py baseline.txt new.txt --threshold 5
+# Exit status is 1 if any median regressed, so it can gate a script.
+
+import argparse
+import sys
+
+
+def lastblock(path):
+    """Results of the last complete run in a capture: name -> (min, median, max)."""
+    runs = []
+    current = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            fields = line.split()
+            if line.startswith("name "):
+                current = {}
+                runs.append(current)
+            elif current is not None and len(fields) == 4 and all(x.isdigit() for x in fields[1:]):
+                current[fields[0]] = tuple(int(x) for x in fields[1:])
+    complete = [r for r in runs if "sleep1" in r]
+    if not complete:
+        sys.exit("%s: no complete benchmark run found" % path)
+    return complete[-1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="allowed median increase in percent (default 5)")
+    args = parser.parse_args()
+    old = lastblock(args.baseline)
+    new = lastblock(args.new)
+    regressed = False
+    print("%-12s %9s %9s %8s" % ("name", "baseline", "new", "change"))
+    for name in old:
+        if name not in new or name == "empty":
+            continue
+        a, b = old[name][1], new[name][1]
+        change = 100.0 * (b - a) / a if a else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressed = True
+        print("%-12s %9d %9d %+7.1f%%%s" % (name, a, b, change, flag))
+    sys.exit(1 if regressed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+// dsptest.c
+// Runs on a Linux host
+// Checks DSP_Sum, DSP_SumSq, DSP_Dot and DSP_MinMax of inc/DSP.c
+// against one-sample-at-a-time loops, for every length 0 to 1001 at
+// each of the four start offsets from a 4-byte boundary, on full
+// range samples.  The host builds the C path of DSP.c; Bench.c runs
+// the same comparison on the board, where the SMLAD/SMLALD path is
+// used for aligned arrays.
+// Exit status is 1 if any result differs.
+// October 19, 2026
+// usage: dsptest
+
+#include <stdint.h>
+#include <stdio.h>
+#include "DSP.h"
+
+#define LENGTH 1001
+#define OFFSETS 4
+
+int16_t X[LENGTH + OFFSETS] __attribute__((aligned(4)));
+int16_t Y[LENGTH + OFFSETS] __attribute__((aligned(4)));
+uint32_t Errors;
+
+static void fail(const char *name, int offset, uint32_t n){
+  if(Errors < 10){
+    printf("%s wrong, offset %d length %u\n", name, offset, n);
+  }
+  Errors++;
+}
+
+int main(void){
+  uint32_t seed = 1, i, n;
+  int offset;
+  int32_t sum;
+  uint64_t sumSq;
+  int64_t dot, dotZ;
+  int16_t lo, hi, min, max;
+  for(i=0; i<LENGTH + OFFSETS; i++){
+    seed = 1664525*seed + 1013904223;
+    X[i] = (int16_t)(seed>>16);        // -32768 to 32767
+    Y[i] = (int16_t)seed;
+  }
+  X[7] = -32768;                       // the extremes, where SMLAD products are largest
+  Y[7] = -32768;
+  X[8] = 32767;
+  for(offset=0; offset<OFFSETS; offset++){
+    const int16_t *x = &X[offset], *y = &Y[offset];
+    const int16_t *z = &Y[offset^1];   // y one sample off, one of x and z is misaligned
+    for(n=0; n<=LENGTH; n++){
+      sum = 0;
+      sumSq = 0;
+      dot = 0;
+      dotZ = 0;
+      for(i=0; i<n; i++){
+        sum += x[i];
+        sumSq += (uint64_t)((int32_t)x[i]*x[i]);
+        dot += (int64_t)x[i]*y[i];
+        dotZ += (int64_t)x[i]*z[i];
+      }
+      if(DSP_Sum(x, n) != sum) fail("DSP_Sum", offset, n);
+      if(DSP_SumSq(x, n) != sumSq) fail("DSP_SumSq", offset, n);
+      if(DSP_Dot(x, y, n) != dot) fail("DSP_Dot", offset, n);
+      if(DSP_Dot(x, z, n) != dotZ) fail("DSP_Dot mixed alignment", offset, n);
+      if(n){
+        lo = hi = x[0];
+        for(i=1; i<n; i++){
+          if(x[i] < lo) lo = x[i];
+          if(x[i] > hi) hi = x[i];
+        }
+        DSP_MinMax(x, n, &min, &max);
+        if((min != lo)||(max != hi)) fail("DSP_MinMax", offset, n);
+      }
+    }
+  }
+  printf("DSP: %u wrong of %u cases\n", Errors, OFFSETS*(LENGTH + 1));
+  return Errors != 0;
+}
@@ -0,0 +1,733 @@
+// fitsim.c
+// Runs on a Linux host
+// Discrete-event simulator of the Lab 4 fitness device.  Replays the
+// eight tasks of Lab4.c on a model of the Lab 4 kernel: SysTick time
+// slices, the 1 kHz sleep timer (runperiodicevents), RealTimeEvents
+// triggering Task1, the microphone block interrupt triggering Task0,
+// and the button edge trigger.  Each task is a list of kernel calls
+// and compute blocks whose costs in bus cycles come from Costs[] and
+// can be changed on the command line, so the effect of THREADFREQ,
+// priorities and task costs on CPU load, response times and
+// LostTask1Data can be seen before flashing the board.  -r compares
+// microphone sampling rates: Task0 CPU use and the blocks it drops.
+// Only the button presses are random, from a seeded generator, so a
+// run with the same options always gives the same numbers.
+// October 19, 2026
+// usage: fitsim [-t seconds] [-f threadfreq[,threadfreq...]] [-b seconds]
+//               [-r rate[,rate...]] [-p task=priority] [-c cost=cycles]
+//               [-s seed] [-l]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BUSCLOCK   80000000  // bus clock in Hz, BSP_Clock_InitFastest
+#define NUMTASKS   8
+#define FSIZE      10        // same as os.c
+#define DEBOUNCEMS 10        // DEBOUNCETIME in Lab4.c
+#define MICBLOCK   128       // samples per block, same as Lab4.c
+#define RINGSIZE   16        // signal times remembered per semaphore, at least FSIZE
+#define PROTO_BEAT 1000      // longest ms Proto_Run blocks, same as Proto.h
+#define FOREVER    UINT64_MAX
+#define US(c)      ((double)(c)*1e6/BUSCLOCK)
+
+//---------------- cost model, bus cycles ----------------
+enum costid{
+  C_SWITCH, C_OSCALL, C_SLEEPISR, C_RTISR, C_EDGEISR,
+  C_MICISR, C_TASK0, C_AUDIO, C_ACCEL, C_TASK1, C_STEP, C_PLOT, C_BUTTON,
+  C_I2C, C_RMS, C_TEXT, NUMCOSTS
+};
+struct cost{
+  const char *name;
+  uint32_t cycles;
+  const char *what;
+};
+struct cost Costs[NUMCOSTS] = {
+  {"switch",     250, "SysTick_Handler and Scheduler"},
+  {"oscall",      40, "OS_Wait, OS_Signal, OS_Sleep, OS_FIFO_Put/Get"},
+  {"sleepisr",    80, "runperiodicevents"},
+  {"rtisr",      100, "RealTimeEvents"},
+  {"edgeisr",     60, "GPIO edge dispatcher"},
+  {"micisr",     150, "ADC1Seq3_Handler, re-arm uDMA and signal"},
+  {"task0",      300, "Task0 per block, MicDMA_Get and timing"},
+  {"audio",       14, "Audio_Block per sample, DC removal, square and peak"},
+  {"accel",      600, "BSP_Accelerometer_Input, three ADC conversions"},
+  {"task1",       80, "Task1 squared magnitude"},
+  {"step",       700, "Task2 sqrt32, EWMA and step state machine"},
+  {"plot",     20000, "Task2 BSP_LCD_PlotPoint and PlotIncrement"},
+  {"button",     300, "Task3 buzzer and mode change"},
+  {"i2cq",       400, "I2CQ_Transfer and I2C1_Handler, one sensor read"},
+  {"rms",        600, "Audio_Block end of window, 64-bit divide and sqrt32"},
+  {"text",    160000, "Task5 five numbers on the LCD"}
+};
+
+//---------------- semaphores ----------------
+enum semid{
+  SoundBlock, TakeAccelerationData, LCDmutex,
+  NewData, SwitchTouch, CurrentSize, ProtoEvent, NUMSEMS
+};
+struct semaphore{
+  const char *name;
+  int32_t initial;
+  int32_t value;
+  uint64_t times[RINGSIZE]; // when each pending signal was made
+  uint32_t head, count;
+  uint32_t overruns;        // signals while the value was already positive
+  int watched;              // OS_Watch by Proto_Run, also signals ProtoEvent
+};
+struct semaphore Sems[NUMSEMS] = {
+  {"SoundBlock", 0}, {"TakeAccelerationData", 0}, {"LCDmutex", 1}, {"NewData", 0},
+  {"SwitchTouch", 0, .watched = 1}, {"CurrentSize", 0}, {"ProtoEvent", 0}
+};
+
+//---------------- task programs ----------------
+enum opcode{
+  RUN,      // compute for Costs[arg] cycles
+  WAIT,     // OS_Wait(&Sems[arg])
+  SIGNAL,   // OS_Signal(&Sems[arg])
+  SLEEP,    // OS_Sleep(arg), response time starts when it wakes
+  UNTIL,    // OS_SleepUntil(&lastWake, arg), response time starts at the release
+  PUT,      // OS_FIFO_Put, counts LostTask1Data when full
+  TAKE,     // rest of OS_FIFO_Get after OS_Wait(&CurrentSize)
+  RELEASE,  // response time starts when the signal the last WAIT took was made
+  DONE,     // response time ends now
+  EVERY,    // skip the next op except every arg-th time
+  BLOCK,    // compute for Costs[arg] cycles per sample of a MICBLOCK block
+  WINDOW,   // skip the next arg ops except when the RMS window ends
+  IDLE,     // WaitForInterrupt forever
+  TRY,      // OS_TryWait(&Sems[arg]), go to op arg2 if it was zero
+  TIMED,    // OS_WaitTimeout(&Sems[ProtoEvent], arg)
+  WAKEAT,   // PROTO_SLEEP(arg) starts, wake = MsTime + arg
+  PSLEEP,   // rest of PROTO_SLEEP, OS_WaitTimeout(&Sems[ProtoEvent]) until wake
+  LOOP      // go to op arg
+};
+struct op{
+  uint8_t code;
+  uint16_t arg;
+  uint16_t arg2;
+};
+const struct op Prog0[] = {  // microphone, one block every MICBLOCK samples
+  {WAIT, SoundBlock}, {RELEASE}, {RUN, C_TASK0}, {BLOCK, C_AUDIO},
+  {WINDOW, 2}, {RUN, C_RMS}, {SIGNAL, NewData}, {DONE}, {LOOP, 0}
+};
+const struct op Prog1[] = {  // accelerometer, 100 ms
+  {WAIT, TakeAccelerationData}, {RELEASE}, {RUN, C_ACCEL}, {RUN, C_TASK1},
+  {PUT}, {DONE}, {LOOP, 0}
+};
+const struct op Prog2[] = {  // steps and plot, after Task1
+  {WAIT, CurrentSize}, {TAKE}, {RELEASE}, {RUN, C_STEP}, {WAIT, LCDmutex},
+  {RUN, C_PLOT}, {SIGNAL, LCDmutex}, {DONE}, {LOOP, 0}
+};
+const struct op Prog3[] = {  // Proto_Run with the Task3 protothread, button and buzzer
+  {TRY, SwitchTouch, 7}, {RELEASE}, {RUN, C_BUTTON}, {WAKEAT, 20}, {PSLEEP},
+  {RUN, C_BUTTON}, {DONE},
+  {TIMED, PROTO_BEAT}, {LOOP, 0}      // nothing can run, block on ProtoEvent
+};
+const struct op Prog4[] = {  // temperature, die and thermopile reads every 1000 ms
+  {UNTIL, 1000}, {RUN, C_I2C}, {RUN, C_I2C}, {DONE}, {LOOP, 0}
+};
+const struct op Prog5[] = {  // numbers on the LCD, every RMS window
+  {WAIT, NewData}, {RELEASE}, {WAIT, LCDmutex},
+  {RUN, C_TEXT}, {SIGNAL, LCDmutex}, {DONE}, {LOOP, 0}
+};
+const struct op Prog6[] = {  // light, every 800 ms
+  {UNTIL, 800}, {RUN, C_I2C}, {DONE}, {LOOP, 0}
+};
+const struct op Prog7[] = {  // background, the kernel idle thread runs in between
+  {SLEEP, 10}, {DONE}, {LOOP, 0}
+};
+
+struct task{
+  const char *name;
+  const struct op *prog;
+  int32_t priority;         // same as OS_AddThreads in Lab4.c
+  uint32_t deadlineMs;      // response longer than this is a miss, 0 for none
+  // run-time state, cleared by reset()
+  uint32_t pc;
+  int32_t blocked;          // semaphore index or -1
+  uint32_t sleeping;        // ms left
+  uint64_t remaining;       // cycles left in the current RUN
+  uint64_t signaled;        // time of the signal taken by the last WAIT
+  uint64_t release;
+  uint32_t every;
+  uint32_t lastWake;        // OS_SleepUntil release in ms
+  uint32_t wake;            // PROTO_SLEEP end in ms
+  // statistics
+  uint64_t busy;            // cycles on the CPU, including its kernel calls
+  uint64_t runs;
+  uint64_t responseSum, responseMin, responseMax;
+  uint32_t misses;          // responses past the deadline, or OS_SleepUntil overruns
+};
+struct task Tasks[NUMTASKS] = {
+  {"Task0", Prog0, 0,    0},
+  {"Task1", Prog1, 1,  100},
+  {"Task2", Prog2, 2,  100},
+  {"Task3", Prog3, 3,    0},  // Proto_Run
+  {"Task4", Prog4, 3,    0},
+  {"Task5", Prog5, 3, 1000},
+  {"Task6", Prog6, 3,    0},
+  {"Task7", Prog7, 4,    0}
+};
+
+//---------------- kernel model ----------------
+uint64_t Now;               // bus cycles since reset
+uint64_t Slice;             // SysTick period
+uint64_t NextSysTick, NextSleepTick, NextRealTime, NextMicBlock, NextButton;
+struct task *RunPt;
+int32_t RealCount;          // RealTimeEvents counter, starts at -10
+uint32_t FifoUsed, FifoMax, LostTask1Data;
+int EdgeArmed;
+uint32_t EdgeRearm;         // MsTime the debounce time of Button1 ends
+uint64_t ButtonPeriod;      // mean time between presses, 0 for none
+uint32_t Presses, PressesLost;
+uint32_t FirstSeed = 1, Seed;
+uint64_t KernelBusy[NUMCOSTS];
+uint64_t IdleTime;
+uint64_t Switches;
+uint32_t MsTime;            // OS_MsTime, counted by runperiodicevents
+uint32_t SoundRate;         // SOUNDRATE, microphone samples per second
+uint32_t WindowBlocks;      // blocks per RMS window, SOUNDWINDOW/MICBLOCK
+uint64_t MicBlocks;         // blocks filled by uDMA
+uint32_t SoundDropped;      // blocks overwritten before Task0 took them
+
+static uint32_t random32(void){  // xorshift32
+  Seed ^= Seed << 13;
+  Seed ^= Seed >> 17;
+  Seed ^= Seed << 5;
+  return Seed;
+}
+static uint64_t nextpress(uint64_t last){
+  // uniform between 0.5 and 1.5 times ButtonPeriod
+  return last + ButtonPeriod/2 + (ButtonPeriod*(random32()%1000))/1000;
+}
+
+static int ready(struct task *pt){
+  return (pt->blocked < 0)&&(pt->sleeping == 0);
+}
+
+// time spent by the kernel with interrupts disabled, events are late
+static void kernel(enum costid id){
+  Now += Costs[id].cycles;
+  KernelBusy[id] += Costs[id].cycles;
+}
+
+// highest priority ready task, round robin starting after RunPt
+static void scheduler(void){
+  struct task *best = 0;
+  int i, n = RunPt - Tasks;
+  for(i=1; i<=NUMTASKS; i++){
+    struct task *pt = &Tasks[(n+i)%NUMTASKS];
+    if(ready(pt) && ((best == 0)||(pt->priority < best->priority))){
+      best = pt;
+    }
+  }
+  if(best){                 // nothing ready: stay on RunPt, CPU idles
+    RunPt = best;
+  }
+}
+
+// SysTick_Handler, run now or after the current interrupt
+static void contextswitch(void){
+  kernel(C_SWITCH);
+  scheduler();
+  Switches++;
+  NextSysTick = Now + Slice;  // OS_Suspend clears STCURRENT
+}
+
+static void pushtime(struct semaphore *s, uint64_t t){
+  if(s->count == RINGSIZE){
+    s->head = (s->head + 1)%RINGSIZE;
+    s->count--;
+  }
+  s->times[(s->head + s->count)%RINGSIZE] = t;
+  s->count++;
+}
+static uint64_t poptime(struct semaphore *s){
+  uint64_t t = Now;
+  if(s->count){
+    t = s->times[s->head];
+    s->head = (s->head + 1)%RINGSIZE;
+    s->count--;
+  }
+  return t;
+}
+
+// OS_Signal from a task or an interrupt
+static void ossignal(int id){
+  struct semaphore *s = &Sems[id];
+  int i, n = RunPt - Tasks;
+  if(s->value > 0){
+    s->overruns++;
+  }
+  s->value++;
+  if(s->value <= 0){        // wake the first blocked task after RunPt
+    for(i=1; i<=NUMTASKS; i++){
+      struct task *pt = &Tasks[(n+i)%NUMTASKS];
+      if(pt->blocked == id){
+        pt->blocked = -1;
+        pt->sleeping = 0;   // if it was in OS_WaitTimeout
+        pt->signaled = Now;
+        return;
+      }
+    }
+  }
+  pushtime(s, Now);
+  if(s->watched && (Sems[ProtoEvent].value <= 0)){
+    ossignal(ProtoEvent);
+  }
+}
+
+// OS_Wait, returns 1 if RunPt blocked
+static int oswait(int id){
+  struct semaphore *s = &Sems[id];
+  s->value--;
+  if(s->value < 0){
+    RunPt->blocked = id;
+    return 1;
+  }
+  RunPt->signaled = poptime(s);
+  return 0;
+}
+
+// OS_WaitTimeout, returns 1 if RunPt blocked
+static int oswaittimeout(int id, uint32_t ms){
+  if(oswait(id)){
+    RunPt->sleeping = ms;     // sleeptick undoes the wait when this runs out
+    return 1;
+  }
+  return 0;
+}
+
+static void respond(struct task *pt){
+  uint64_t r = Now - pt->release;
+  pt->runs++;
+  pt->responseSum += r;
+  if(r < pt->responseMin){
+    pt->responseMin = r;
+  }
+  if(r > pt->responseMax){
+    pt->responseMax = r;
+  }
+  if(pt->deadlineMs && (r > (uint64_t)pt->deadlineMs*(BUSCLOCK/1000))){
+    pt->misses++;
+  }
+}
+
+// execute ops of RunPt until it has to spend time or gives up the CPU
+static void step(void){
+  struct task *pt = RunPt;
+  const struct op *op;
+  uint64_t start;
+  while(ready(pt) && (pt->remaining == 0)){
+    op = &pt->prog[pt->pc];
+    start = Now;
+    switch(op->code){
+      case RUN:
+        pt->remaining = Costs[op->arg].cycles;
+        pt->pc++;
+        break;
+      case WAIT:
+        pt->pc++;
+        kernel(C_OSCALL);
+        if(oswait(op->arg)){
+          pt->busy += Now - start;
+          contextswitch();
+          return;
+        }
+        break;
+      case SIGNAL:
+        pt->pc++;
+        kernel(C_OSCALL);
+        ossignal(op->arg);
+        break;
+      case SLEEP:
+        pt->pc++;
+        kernel(C_OSCALL);
+        pt->sleeping = op->arg;
+        pt->release = (uint64_t)(MsTime + op->arg)*(BUSCLOCK/1000);
+        pt->busy += Now - start;
+        contextswitch();
+        return;
+      case UNTIL:               // same rule as OS_SleepUntil in os.c
+        pt->pc++;
+        kernel(C_OSCALL);
+        pt->busy += Now - start;
+        if((int32_t)(pt->lastWake + op->arg - MsTime) > 0){
+          pt->lastWake += op->arg;
+          pt->sleeping = pt->lastWake - MsTime;
+          pt->release = (uint64_t)pt->lastWake*(BUSCLOCK/1000);
+          contextswitch();
+          return;
+        }
+        {
+          uint32_t next = pt->lastWake + op->arg;
+          uint32_t missed = (MsTime - next)/op->arg;
+          pt->lastWake = next + missed*op->arg;
+          pt->release = (uint64_t)pt->lastWake*(BUSCLOCK/1000);
+          pt->misses += missed;
+          if(MsTime != pt->lastWake){   // ceil((MsTime-next)/period)
+            pt->misses += 1;
+          }
+        }
+        start = Now;
+        break;
+      case TRY:
+        kernel(C_OSCALL);
+        if(Sems[op->arg].value > 0){
+          oswait(op->arg);
+          pt->pc++;
+        } else{
+          pt->pc = op->arg2;
+        }
+        break;
+      case TIMED:
+        pt->pc++;
+        kernel(C_OSCALL);
+        if(oswaittimeout(ProtoEvent, op->arg)){
+          pt->busy += Now - start;
+          contextswitch();
+          return;
+        }
+        break;
+      case WAKEAT:
+        pt->pc++;
+        pt->wake = MsTime + op->arg;
+        break;
+      case PSLEEP:              // stays on this op until wake, another pass per ProtoEvent
+        if((int32_t)(MsTime - pt->wake) >= 0){
+          pt->pc++;
+          break;
+        }
+        kernel(C_OSCALL);
+        if(oswaittimeout(ProtoEvent, pt->wake - MsTime)){
+          pt->busy += Now - start;
+          contextswitch();
+          return;
+        }
+        break;
+      case PUT:
+        pt->pc++;
+        kernel(C_OSCALL);
+        if(FifoUsed == FSIZE){
+          LostTask1Data++;
+        } else{
+          FifoUsed++;
+          if(FifoUsed > FifoMax){
+            FifoMax = FifoUsed;
+          }
+          ossignal(CurrentSize);
+        }
+        break;
+      case TAKE:
+        pt->pc++;
+        FifoUsed--;
+        break;
+      case RELEASE:
+        pt->pc++;
+        pt->release = pt->signaled;
+        break;
+        case DONE:
+        pt->pc++;
+        respond(pt);
+        break;
+      case BLOCK:
+        pt->remaining = (uint64_t)Costs[op->arg].cycles*MICBLOCK;
+        pt->pc++;
+        break;
+      case WINDOW:              // Audio_Block, the window is whole blocks
+        pt->every++;
+        if(pt->every == WindowBlocks){
+          pt->every = 0;
+          pt->pc++;
+        } else{
+          pt->pc += 1 + op->arg;
+        }
+        break;
+      case EVERY:
+        pt->every++;
+        if(pt->every == op->arg){
+          pt->every = 0;
+          pt->pc++;
+        } else{
+          pt->pc += 2;
+        }
+        break;
+      case IDLE:
+        pt->remaining = FOREVER;
+        break;
+      case LOOP:
+        pt->pc = op->arg;
+        break;
+    }
+    pt->busy += Now - start;
+  }
+}
+
+static void sleeptick(void){  // runperiodicevents
+  kernel(C_SLEEPISR);
+  MsTime++;
+  if((EdgeArmed == 0)&&(MsTime == EdgeRearm)){
+    EdgeArmed = 1;              // edgerearm, a press outlasts the debounce time
+    ossignal(SwitchTouch);
+  }
+  for(int i=0; i<NUMTASKS; i++){
+    if(Tasks[i].sleeping){
+      Tasks[i].sleeping--;
+      if((Tasks[i].sleeping == 0)&&(Tasks[i].blocked >= 0)){
+        Sems[Tasks[i].blocked].value++;   // OS_WaitTimeout gave up
+        Tasks[i].blocked = -1;
+      }
+    }
+  }
+}
+static void realtime(void){   // RealTimeEvents with one 100 ms trigger
+  kernel(C_RTISR);
+  RealCount++;
+  if((RealCount >= 0)&&((RealCount%100) == 0)){
+    ossignal(TakeAccelerationData);
+    contextswitch();            // OS_Suspend pends SysTick
+  }
+}
+static void micblock(void){   // ADC1Seq3_Handler, uDMA filled a block
+  kernel(C_MICISR);
+  if(Sems[SoundBlock].value > 0){
+    SoundDropped++;             // MicDMA_Lost, the pending block is overwritten
+    return;
+  }
+  ossignal(SoundBlock);
+  contextswitch();
+}
+static void button(void){     // GPIO edge dispatcher, Button1 on PD6
+  Presses++;
+  if(EdgeArmed == 0){
+    PressesLost++;
+    return;
+  }
+  kernel(C_EDGEISR);
+  EdgeArmed = 0;                // Task3 is signaled when the debounce time ends
+  EdgeRearm = MsTime + DEBOUNCEMS;
+}
+
+static void reset(uint32_t threadFreq, uint32_t soundRate){
+  int i;
+  Now = 0;
+  Slice = BUSCLOCK/threadFreq;
+  NextSysTick = Slice;
+  NextSleepTick = BUSCLOCK/1000;
+  NextRealTime = BUSCLOCK/1000;
+  SoundRate = soundRate;
+  WindowBlocks = soundRate/MICBLOCK;
+  if(WindowBlocks == 0){
+    WindowBlocks = 1;
+  }
+  MicBlocks = SoundDropped = 0;
+  NextMicBlock = (uint64_t)BUSCLOCK*MICBLOCK/soundRate;
+  RealCount = -10;
+  MsTime = 0;
+  Seed = FirstSeed;         // same presses for every THREADFREQ
+  FifoUsed = FifoMax = LostTask1Data = 0;
+  EdgeArmed = 1;
+  Presses = PressesLost = 0;
+  IdleTime = Switches = 0;
+  memset(KernelBusy, 0, sizeof(KernelBusy));
+  for(i=0; i<NUMSEMS; i++){
+    Sems[i].value = Sems[i].initial;
+    Sems[i].head = Sems[i].count = Sems[i].overruns = 0;
+  }
+  for(i=0; i<NUMTASKS; i++){
+    struct task *pt = &Tasks[i];
+    pt->pc = 0;
+    pt->blocked = -1;
+    pt->sleeping = 0;
+    pt->remaining = 0;
+    pt->signaled = pt->release = 0;
+    pt->every = 0;
+    pt->lastWake = 0;
+    pt->wake = 0;
+    pt->busy = pt->runs = pt->responseSum = pt->responseMax = 0;
+    pt->responseMin = FOREVER;
+    pt->misses = 0;
+  }
+  RunPt = &Tasks[0];
+}
+
+static void simulate(uint64_t end){
+  uint64_t next, used;
+  NextButton = ButtonPeriod ? nextpress(0) : FOREVER;
+  while(Now < end){
+    step();
+    next = NextSysTick;
+    if(NextSleepTick < next) next = NextSleepTick;
+    if(NextRealTime < next) next = NextRealTime;
+    if(NextMicBlock < next) next = NextMicBlock;
+    if(NextButton < next) next = NextButton;
+    if(next > Now){           // RunPt runs until the next interrupt or its RUN ends
+      used = next - Now;
+      if(ready(RunPt)){
+        if(RunPt->remaining < used){
+          used = RunPt->remaining;
+        }
+        if(RunPt->prog[RunPt->pc].code == IDLE){
+          IdleTime += used;
+        } else{
+          RunPt->remaining -= used;
+          RunPt->busy += used;
+        }
+      } else{
+        IdleTime += used;
+      }
+      Now += used;
+      if(Now < next){
+        continue;
+      }
+    }
+    // interrupts in priority order, a late one is taken as soon as possible
+    if(NextRealTime <= Now){
+      NextRealTime += BUSCLOCK/1000;
+      realtime();
+    } else if(NextMicBlock <= Now){
+      MicBlocks++;
+      NextMicBlock = (uint64_t)BUSCLOCK*MICBLOCK*(MicBlocks + 1)/SoundRate;
+      micblock();
+    } else if(NextSleepTick <= Now){
+      NextSleepTick += BUSCLOCK/1000;
+      sleeptick();
+    } else if(NextButton <= Now){
+      NextButton = nextpress(NextButton);
+      button();
+    } else if(NextSysTick <= Now){
+      contextswitch();
+    }
+  }
+}
+
+static void report(uint32_t threadFreq, double seconds, double wall){
+  int i;
+  uint64_t kernelSum = 0;
+  printf("THREADFREQ %u Hz, SOUNDRATE %u Hz, %.0f s simulated in %.2f s\n",
+         threadFreq, SoundRate, seconds, wall);
+  printf("task  prio        runs   cpu%%   response us: min       avg       max   misses\n");
+  for(i=0; i<NUMTASKS; i++){
+    struct task *pt = &Tasks[i];
+    printf("%-5s %4d %11llu %6.2f", pt->name, pt->priority,
+           (unsigned long long)pt->runs, 100.0*pt->busy/Now);
+    if(pt->runs){
+      printf("  %17.1f %9.1f %9.1f %8u\n", US(pt->responseMin),
+             US((double)pt->responseSum/pt->runs), US(pt->responseMax), pt->misses);
+    } else{
+      printf("\n");
+    }
+  }
+  for(i=0; i<NUMCOSTS; i++){
+    kernelSum += KernelBusy[i];
+  }
+  printf("kernel %.2f%% (switch %.2f%%, timer and ADC ISRs %.2f%%), %.1f switches/s, idle %.2f%%\n",
+         100.0*kernelSum/Now, 100.0*KernelBusy[C_SWITCH]/Now,
+         100.0*(KernelBusy[C_SLEEPISR] + KernelBusy[C_RTISR] + KernelBusy[C_MICISR])/Now,
+         Switches/seconds, 100.0*IdleTime/Now);
+  printf("LostTask1Data %u, FIFO max %u of %u, sound blocks dropped %u of %llu, overruns TakeAccelerationData %u",
+         LostTask1Data, FifoMax, FSIZE, SoundDropped,
+         (unsigned long long)MicBlocks, Sems[TakeAccelerationData].overruns);
+  if(ButtonPeriod){
+    printf(", button presses %u (%u while debouncing)", Presses, PressesLost);
+  }
+  printf("\n\n");
+}
+
+static void listcosts(void){
+  int i;
+  for(i=0; i<NUMCOSTS; i++){
+    printf("%-9s %7u cycles  %s\n", Costs[i].name, Costs[i].cycles, Costs[i].what);
+  }
+}
+
+// parse name=value, returns the table index or -1
+static int setting(const char *arg, const char *names[], int n, long *value){
+  const char *eq = strchr(arg, '=');
+  int i;
+  if(eq == 0){
+    return -1;
+  }
+  for(i=0; i<n; i++){
+    if((strlen(names[i]) == (size_t)(eq - arg)) && (strncmp(arg, names[i], eq - arg) == 0)){
+      *value = strtol(eq + 1, 0, 0);
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void usage(void){
+  fprintf(stderr,
+    "usage: fitsim [-t seconds] [-f threadfreq[,threadfreq...]] [-b seconds]\n"
+    "              [-r rate[,rate...]] [-p task=priority] [-c cost=cycles]\n"
+    "              [-s seed] [-l]\n"
+    "  -t  simulated time, default 3600 s\n"
+    "  -f  SysTick time slice rates to compare, default 1000 Hz\n"
+    "  -b  mean time between button presses, default 0 (none)\n"
+    "  -r  microphone sampling rates to compare, default 8000 Hz\n"
+    "  -p  task priority, for example -p Task2=1\n"
+    "  -c  cost in bus cycles, for example -c plot=40000\n"
+    "  -l  list the cost model and exit\n");
+  exit(2);
+}
+
+int main(int argc, char *argv[]){
+  const char *names[NUMCOSTS > NUMTASKS ? NUMCOSTS : NUMTASKS];
+  const char *freqs = "1000";
+  const char *rates = "8000";
+  double seconds = 3600, wall;
+  long value;
+  int c, i;
+  char *list, *f, *rlist, *r, *save;
+  struct timespec t0, t1;
+  while((c = getopt(argc, argv, "t:f:b:r:p:c:s:l")) != -1){
+    switch(c){
+      case 't': seconds = atof(optarg); break;
+      case 'f': freqs = optarg; break;
+      case 'r': rates = optarg; break;
+      case 'b': ButtonPeriod = (uint64_t)(atof(optarg)*BUSCLOCK); break;
+      case 's': FirstSeed = strtoul(optarg, 0, 0); if(FirstSeed == 0) FirstSeed = 1; break;
+      case 'l': listcosts(); return 0;
+      case 'p':
+        for(i=0; i<NUMTASKS; i++) names[i] = Tasks[i].name;
+        i = setting(optarg, names, NUMTASKS, &value);
+        if(i < 0) usage();
+        Tasks[i].priority = value;
+        break;
+      case 'c':
+        for(i=0; i<NUMCOSTS; i++) names[i] = Costs[i].name;
+        i = setting(optarg, names, NUMCOSTS, &value);
+        if(i < 0) usage();
+        Costs[i].cycles = value;
+        break;
+      default: usage();
+    }
+  }
+  rlist = strdup(rates);
+  for(r = strtok_r(rlist, ",", &save); r; r = strtok_r(0, ",", &save)){
+    uint32_t soundRate = strtoul(r, 0, 0);
+    if((soundRate == 0)||(soundRate > 1000000)){
+      usage();
+    }
+    list = strdup(freqs);
+    for(f = strtok(list, ","); f; f = strtok(0, ",")){
+      uint32_t threadFreq = strtoul(f, 0, 0);
+      if((threadFreq == 0)||(threadFreq > BUSCLOCK/1000)){
+        usage();
+      }
+      reset(threadFreq, soundRate);
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+      simulate((uint64_t)(seconds*BUSCLOCK));
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec)/1e9;
+      report(threadFreq, seconds, wall);
+    }
+    free(list);
+  }
+  free(rlist);
+  return 0;
+}
@@ -0,0 +1,19 @@
+// host.h
+// Runs on a Linux host
+// Functions the host port provides in addition to osport.h,
+// CortexM.h and BSP.h.
+// October 19, 2026
+
+#ifndef __HOST_H
+#define __HOST_H  1
+
+#define HOSTTICKHZ 1000   // rate of the SIGALRM that simulates SysTick and the periodic timers
+
+// ******** Host_StopTimer ************
+// Stop the simulated interrupts and leave them disabled,
+// so a thread can print results and exit the process
+// Inputs:  none
+// Outputs: none
+void Host_StopTimer(void);
+
+#endif
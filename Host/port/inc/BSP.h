@@ -0,0 +1,43 @@
+// BSP.h
+// Runs on a Linux host
+// Host replacement for the parts of ../inc/BSP.h used by os.c.
+// Periodic tasks are run by the simulated timer interrupt in
+// osport_host.c, at multiples of HOSTTICKHZ.
+// October 19, 2026
+
+#ifndef __BSP_H
+#define __BSP_H  1
+#include <stdint.h>
+
+// ------------BSP_Clock_InitFastest------------
+// Nothing to do on the host
+// Input: none
+// Output: none
+void BSP_Clock_InitFastest(void);
+
+// ------------BSP_Clock_GetFreq------------
+// Return the simulated bus clock, used to convert the
+// time slice given to OS_Launch into host time
+// Input: none
+// Output: 80,000,000 Hz
+uint32_t BSP_Clock_GetFreq(void);
+
+// ------------BSP_PeriodicTask_Init------------
+// Run a function periodically from the simulated timer interrupt
+// Input: task is a pointer to a user function
+//        freq is number of interrupts per second, 1 to HOSTTICKHZ
+//        priority is ignored, periodic tasks run before SysTick
+// Output: none
+void BSP_PeriodicTask_Init(void(*task)(void), uint32_t freq, uint8_t priority);
+void BSP_PeriodicTask_InitB(void(*task)(void), uint32_t freq, uint8_t priority);
+void BSP_PeriodicTask_InitC(void(*task)(void), uint32_t freq, uint8_t priority);
+
+// ------------BSP_PeriodicTask_Stop------------
+// Stop a periodic task
+// Input: none
+// Output: none
+void BSP_PeriodicTask_Stop(void);
+void BSP_PeriodicTask_StopB(void);
+void BSP_PeriodicTask_StopC(void);
+
+#endif
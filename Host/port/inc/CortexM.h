@@ -0,0 +1,43 @@
+// CortexM.h
+// Runs on a Linux host
+// Host replacement for ../inc/CortexM.h used by Host/port.
+// The I bit is simulated: while interrupts are disabled, the
+// SysTick and periodic timer signals are held pending and are
+// serviced by EnableInterrupts or EndCritical.
+// October 19, 2026
+
+#ifndef __CORTEXM_H
+#define __CORTEXM_H  1
+#include <stdint.h>
+
+// *********** DisableInterrupts ************
+// disable interrupts
+// inputs:  none
+// outputs: none
+void DisableInterrupts(void);
+
+// *********** EnableInterrupts ************
+// enable interrupts, then service anything that became pending
+// inputs:  none
+// outputs: none
+void EnableInterrupts(void);
+
+// *********** StartCritical ************
+// make a copy of the I bit, then disable interrupts
+// inputs:  none
+// outputs: previous I bit
+long StartCritical(void);
+
+// *********** EndCritical ************
+// using the copy of the I bit, restore it to its previous value
+// inputs:  previous I bit
+// outputs: none
+void EndCritical(long sr);
+
+// *********** WaitForInterrupt ************
+// sleep until the next simulated interrupt
+// inputs:  none
+// outputs: none
+void WaitForInterrupt(void);
+
+#endif
@@ -0,0 +1,42 @@
+// UART0.h
+// Runs on a Linux host
+// Host replacement for the parts of ../inc/UART0.h used by the
+// Lab 4 kernel options (SemStats.c, Deadlock.c).  Output goes to
+// stdout instead of the serial port.
+// October 19, 2026
+
+#ifndef __UART0_H
+#define __UART0_H  1
+#include <stdint.h>
+
+//------------UART0_Init------------
+// Nothing to do on the host
+// Input: none
+// Output: none
+void UART0_Init(void);
+
+//------------UART0_OutChar------------
+// Output 8-bit to stdout
+// Input: letter is an 8-bit ASCII character to be transferred
+// Output: none
+void UART0_OutChar(char data);
+
+//------------UART0_OutString------------
+// Output String (NULL termination)
+// Input: pointer to a NULL-terminated string to be transferred
+// Output: none
+void UART0_OutString(char *pt);
+
+//-----------------------UART0_OutUDec-----------------------
+// Output a 32-bit number in unsigned decimal format
+// Input: 32-bit number to be transferred
+// Output: none
+void UART0_OutUDec(uint32_t n);
+
+//--------------------------UART0_OutUHex----------------------------
+// Output a 32-bit number in unsigned hexadecimal format
+// Input: 32-bit number to be transferred
+// Output: none
+void UART0_OutUHex(uint32_t number);
+
+#endif
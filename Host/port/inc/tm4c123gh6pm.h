@@ -0,0 +1,19 @@
+// tm4c123gh6pm.h
+// Runs on a Linux host
+// Host replacement for ../inc/tm4c123gh6pm.h.  The I/O registers
+// touched by os.c are ordinary variables, so hardware drivers in
+// os.c compile on the host (they are not used by the host port).
+// October 19, 2026
+
+#ifndef __TM4C123GH6PM_H__
+#define __TM4C123GH6PM_H__
+#include <stdint.h>
+
+#define HOSTNUMREGS 64
+extern volatile uint32_t HostRegisters[HOSTNUMREGS];
+
+#define SYSCTL_RCGCGPIO_R       (HostRegisters[0])
+#define SYSCTL_PRGPIO_R         (HostRegisters[1])
+#define NVIC_EN0_R              (HostRegisters[2])
+
+#endif
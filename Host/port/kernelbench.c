@@ -0,0 +1,200 @@
+// kernelbench.c
+// Runs on a Linux host
+// Runs the Lab 4 kernel on the host port and measures its main paths
+// in wall-clock time: OS_Suspend context switches, OS_Signal/OS_Wait
+// ping-pong, OS_FIFO_Put/OS_FIFO_Get, the Scheduler decision alone
+// and OS_Sleep wake-up error.
+// Host numbers are only good for comparing kernel changes with each
+// other; cycle counts on the TM4C123 come from the target benchmark.
+// October 19, 2026
+// Built with OS_SEMSTATS=1 (make semstats) it also prints the
+// SemStats_Print table of its semaphores at the end.
+// usage: kernelbench [iterations]
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "os.h"
+#include "CortexM.h"
+#include "BSP.h"
+#include "host.h"
+#include "SemStats.h"
+
+#define THREADFREQ 1000   // frequency in Hz of round robin scheduler
+#define SLEEPS     200    // number of OS_Sleep(1) calls measured
+
+// kernel symbols, the TCB is private to os.c
+struct tcb;
+extern struct tcb *RunPt;
+void Scheduler(void);
+
+uint32_t Iterations = 200000;
+int32_t StartSwitch, StartPing, StartFifo, Done;
+int32_t Ping, Pong;
+
+static uint64_t nanoseconds(void){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec*1000000000 + now.tv_nsec;
+}
+
+// two threads at the same priority yielding to each other
+void SwitchA(void){
+  OS_Wait(&StartSwitch);
+  for(uint32_t i=0; i<Iterations; i++){
+    OS_Suspend();
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartSwitch);  // never signaled again
+  }
+}
+void SwitchB(void){
+  OS_Wait(&StartSwitch);
+  for(uint32_t i=0; i<Iterations; i++){
+    OS_Suspend();
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartSwitch);
+  }
+}
+
+// semaphore ping-pong, two blocking waits and two switches per round
+void PingThread(void){
+  OS_Wait(&StartPing);
+  for(uint32_t i=0; i<Iterations; i++){
+    OS_Signal(&Ping);
+    OS_Wait(&Pong);
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartPing);
+  }
+}
+void PongThread(void){
+  OS_Wait(&StartPing);
+  for(uint32_t i=0; i<Iterations; i++){
+    OS_Wait(&Ping);
+    OS_Signal(&Pong);
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartPing);
+  }
+}
+
+// FIFO producer yields when the FIFO is full
+void Producer(void){
+  OS_Wait(&StartFifo);
+  for(uint32_t i=0; i<Iterations; i++){
+    while(OS_FIFO_Put(i) == -1){
+      OS_Suspend();
+    }
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartFifo);
+  }
+}
+uint32_t FifoErrors;
+void Consumer(void){
+  OS_Wait(&StartFifo);
+  for(uint32_t i=0; i<Iterations; i++){
+    if(OS_FIFO_Get() != i){
+      FifoErrors++;
+    }
+  }
+  OS_Signal(&Done);
+  while(1){
+    OS_Wait(&StartFifo);
+  }
+}
+
+static void report(const char *name, uint64_t elapsed, uint32_t operations){
+  printf("%-34s %10u ops %10.1f ns/op\n", name, operations,
+         (double)elapsed/operations);
+}
+
+// highest priority, runs each test in turn
+void Controller(void){
+  uint64_t start, elapsed[4], sleepSum, sleepMax, t;
+  struct tcb *self;
+  start = nanoseconds();
+  OS_Signal(&StartSwitch); OS_Signal(&StartSwitch);
+  OS_Wait(&Done); OS_Wait(&Done);
+  elapsed[0] = nanoseconds() - start;
+
+  start = nanoseconds();
+  OS_Signal(&StartPing); OS_Signal(&StartPing);
+  OS_Wait(&Done); OS_Wait(&Done);
+  elapsed[1] = nanoseconds() - start;
+
+  start = nanoseconds();
+  OS_Signal(&StartFifo); OS_Signal(&StartFifo);
+  OS_Wait(&Done); OS_Wait(&Done);
+  elapsed[2] = nanoseconds() - start;
+
+  // Scheduler with the other seven threads blocked; no switch results
+  DisableInterrupts();
+  self = RunPt;
+  start = nanoseconds();
+  for(uint32_t i=0; i<10*Iterations; i++){
+    Scheduler();
+  }
+  elapsed[3] = nanoseconds() - start;
+  RunPt = self;
+  EnableInterrupts();
+
+  sleepSum = sleepMax = 0;
+  for(int i=0; i<SLEEPS; i++){
+    start = nanoseconds();
+    OS_Sleep(1);
+    t = nanoseconds() - start;
+    sleepSum += t;
+    if(t > sleepMax){
+      sleepMax = t;
+    }
+  }
+
+  Host_StopTimer();
+  report("OS_Suspend context switch", elapsed[0], 2*Iterations);
+  report("OS_Signal/OS_Wait ping-pong round", elapsed[1], Iterations);
+  report("OS_FIFO_Put/OS_FIFO_Get pair", elapsed[2], Iterations);
+  report("Scheduler decision", elapsed[3], 10*Iterations);
+  printf("%-34s %10u ops %10.1f us average, %.1f us max\n", "OS_Sleep(1)",
+         SLEEPS, sleepSum/1000.0/SLEEPS, sleepMax/1000.0);
+  if(FifoErrors){
+    printf("FIFO data errors: %u\n", FifoErrors);
+  }
+#if OS_SEMSTATS
+  SemStats_Print();
+#endif
+  exit(FifoErrors != 0);
+}
+
+int main(int argc, char *argv[]){
+  if(argc > 1){
+    Iterations = strtoul(argv[1], 0, 0);
+  }
+  OS_Init();
+  OS_InitSemaphore(&StartSwitch, 0);
+  OS_InitSemaphore(&StartPing, 0);
+  OS_InitSemaphore(&StartFifo, 0);
+  OS_InitSemaphore(&Done, 0);
+  OS_InitSemaphore(&Ping, 0);
+  OS_InitSemaphore(&Pong, 0);
+  SEMSTATS_REGISTER(&StartSwitch, "StartSwitch");
+  SEMSTATS_REGISTER(&StartPing, "StartPing");
+  SEMSTATS_REGISTER(&StartFifo, "StartFifo");
+  SEMSTATS_REGISTER(&Done, "Done");
+  SEMSTATS_REGISTER(&Ping, "Ping");
+  SEMSTATS_REGISTER(&Pong, "Pong");
+  OS_FIFO_Init();
+  OS_AddThreads(&Controller,0, &SwitchA,1, &SwitchB,1, &PingThread,1,
+                &PongThread,1, &Producer,1, &Consumer,1, 0,0);
+  OS_Launch(BSP_Clock_GetFreq()/THREADFREQ); // doesn't return
+  return 0;
+}
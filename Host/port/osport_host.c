@@ -0,0 +1,339 @@
+// osport_host.c
+// Runs on a Linux host
+// Host implementation of osport.h, CortexM.h and the BSP timers, so the
+// kernel in Lab4_Fitness_4C123/os.c runs unchanged as a user process.
+// Each thread gets a ucontext with its own host stack; SIGALRM at
+// HOSTTICKHZ plays the role of SysTick and of the periodic timers.
+// October 19, 2026
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "osport.h"
+#include "CortexM.h"
+#include "BSP.h"
+#include "tm4c123gh6pm.h"
+#include "host.h"
+
+#define HOSTCLOCK   80000000 // simulated bus clock in Hz
+#define HOSTTHREADS 16       // maximum number of kernel threads
+#define HOSTSTACK   65536    // bytes of host stack per thread, the kernel Stacks[] are too small for libc
+#define NUMHOSTPERIODIC 3    // BSP_PeriodicTask_Init, InitB and InitC
+
+// kernel symbols, struct tcb is private to os.c but starts with sp
+struct tcb;
+extern struct tcb *RunPt;
+void Scheduler(void);
+void WakeupHandler(void);
+
+volatile uint32_t HostRegisters[HOSTNUMREGS];
+
+struct hostthread{
+  osFrameType *frame;      // tcb->sp of the kernel thread, never changed on the host
+  void(*thread)(void);
+  void *stack;             // HOSTSTACK bytes
+  ucontext_t context;
+};
+typedef struct hostthread hostThreadType;
+static hostThreadType Threads[HOSTTHREADS];
+static int NumThreads;
+static hostThreadType *Current;
+static ucontext_t HostMain;
+
+struct hostperiodic{
+  void(*task)(void);
+  uint32_t period;         // in HOSTTICKHZ ticks
+  uint32_t count;
+};
+static struct hostperiodic Periodic[NUMHOSTPERIODIC];
+
+static volatile sig_atomic_t Masked = 1;      // simulated I bit, 1 means disabled
+static volatile sig_atomic_t TickPending;     // timer signal while masked
+static volatile sig_atomic_t SwitchPending;   // OSPort_Suspend while masked
+static volatile sig_atomic_t WakePending;     // sleep timer compare reached
+static int WakeArmed;
+static uint32_t WakeTime;                     // OSPort_TimerCompare, checked every tick
+static uint32_t SliceTicks;                   // nonzero once OSPort_Launch starts slicing
+static uint32_t SliceCount;                   // HOSTTICKHZ ticks left in the current slice
+static uint32_t WatchdogTimeout;              // OSPort_WatchdogInit, 0 if not started
+static uint32_t WatchdogFed;                  // OSPort_Cycles at the last feed
+
+//------------Host thread contexts------------
+// OSPort_InitStack makes a context for each thread; the switch
+// finds it again from the frame address stored in tcb->sp
+static void threadstart(void){
+  EnableInterrupts();      // threads run with interrupts enabled
+  Current->thread();
+  fprintf(stderr, "host port: thread returned\n");
+  exit(1);
+}
+// (re)start the context of the thread whose frame is at frame
+static hostThreadType *makethread(osFrameType *frame){
+  hostThreadType *pt = 0;
+  for(int i=0; i<NumThreads; i++){
+    if(Threads[i].frame == frame){
+      pt = &Threads[i];    // same stack initialized again
+    }
+  }
+  if(pt == 0){
+    if(NumThreads == HOSTTHREADS){
+      fprintf(stderr, "host port: too many threads\n");
+      exit(1);
+    }
+    pt = &Threads[NumThreads++];
+    pt->frame = frame;
+    pt->stack = malloc(HOSTSTACK);
+  }
+  pt->thread = frame->pc;
+  getcontext(&pt->context);
+  pt->context.uc_stack.ss_sp = pt->stack;
+  pt->context.uc_stack.ss_size = HOSTSTACK;
+  pt->context.uc_link = 0;
+  sigemptyset(&pt->context.uc_sigmask);
+  makecontext(&pt->context, threadstart, 0);
+  return pt;
+}
+// a frame that OSPort_InitStack has not seen was built at compile
+// time with OSPORT_FRAME, its context is made the first time it runs
+static hostThreadType *lookup(struct tcb *pt){
+  osFrameType *frame = *(osFrameType **)pt;   // sp is the first field of the TCB
+  for(int i=0; i<NumThreads; i++){
+    if(Threads[i].frame == frame){
+      return &Threads[i];
+    }
+  }
+  return makethread(frame);
+}
+
+// SysTick_Handler, called with Masked==1
+static void contextswitch(void){
+  hostThreadType *old = Current;
+  Scheduler();
+  Current = lookup(RunPt);   // Scheduler has set SliceCount
+  if(Current != old){
+    swapcontext(&old->context, &Current->context);
+  }
+}
+
+// one simulated timer interrupt, called with Masked==1
+static void tick(void){
+  for(int i=0; i<NUMHOSTPERIODIC; i++){
+    if(Periodic[i].task){
+      Periodic[i].count--;
+      if(Periodic[i].count == 0){
+        Periodic[i].count = Periodic[i].period;
+        Periodic[i].task();
+      }
+    }
+  }
+  if(WakeArmed && ((int32_t)(WakeTime - OSPort_TimerNow()) <= 0)){
+    WakeArmed = 0;
+    WakePending = 1;
+  }
+  if(WatchdogTimeout && ((OSPort_Cycles() - WatchdogFed) > WatchdogTimeout)){
+    fprintf(stderr, "host port: watchdog reset\n");
+    exit(2);
+  }
+  if(SliceTicks){
+    SliceCount--;
+    if(SliceCount == 0){
+      SwitchPending = 1;
+    }
+  }
+}
+
+// service pending interrupts, then leave them enabled
+static void unmask(void){
+  while(1){
+    Masked = 0;
+    if((TickPending == 0)&&(SwitchPending == 0)&&(WakePending == 0)){
+      return;
+    }
+    Masked = 1;
+    if(TickPending){
+      TickPending = 0;
+      tick();
+    }
+    if(WakePending){
+      WakePending = 0;
+      WakeupHandler();
+    }
+    if(SwitchPending && SliceTicks){
+      SwitchPending = 0;
+      contextswitch();
+    }
+  }
+}
+
+static void alarmhandler(int signal){
+  (void)signal;
+  if(Masked){
+    TickPending = 1;       // taken by EnableInterrupts/EndCritical
+    return;
+  }
+  TickPending = 1;
+  unmask();
+}
+
+//------------CortexM.h------------
+void DisableInterrupts(void){
+  Masked = 1;
+}
+void EnableInterrupts(void){
+  unmask();
+}
+long StartCritical(void){
+  long sr = Masked;
+  Masked = 1;
+  return sr;
+}
+void EndCritical(long sr){
+  if(sr){
+    Masked = 1;
+  } else{
+    unmask();
+  }
+}
+void WaitForInterrupt(void){
+  pause();
+}
+
+//------------BSP.h------------
+void BSP_Clock_InitFastest(void){
+}
+uint32_t BSP_Clock_GetFreq(void){
+  return HOSTCLOCK;
+}
+static void periodicinit(int n, void(*task)(void), uint32_t freq){
+  uint32_t period = HOSTTICKHZ/freq;
+  if(period == 0){
+    period = 1;            // cannot run faster than the host tick
+  }
+  Periodic[n].period = Periodic[n].count = period;
+  Periodic[n].task = task;
+}
+void BSP_PeriodicTask_Init(void(*task)(void), uint32_t freq, uint8_t priority){
+  (void)priority;
+  periodicinit(0, task, freq);
+}
+void BSP_PeriodicTask_InitB(void(*task)(void), uint32_t freq, uint8_t priority){
+  (void)priority;
+  periodicinit(1, task, freq);
+}
+void BSP_PeriodicTask_InitC(void(*task)(void), uint32_t freq, uint8_t priority){
+  (void)priority;
+  periodicinit(2, task, freq);
+}
+void BSP_PeriodicTask_Stop(void){
+  Periodic[0].task = 0;
+}
+void BSP_PeriodicTask_StopB(void){
+  Periodic[1].task = 0;
+}
+void BSP_PeriodicTask_StopC(void){
+  Periodic[2].task = 0;
+}
+
+//------------osport.h------------
+// time slices are rounded to host ticks, at least one
+static uint32_t toticks(uint32_t cycles){
+  uint32_t ticks = (uint32_t)(((uint64_t)cycles*HOSTTICKHZ)/HOSTCLOCK);
+  return ticks ? ticks : 1;
+}
+void OSPort_SetSlice(uint32_t theTimeSlice){
+  SliceCount = toticks(theTimeSlice);
+}
+uint32_t OSPort_SliceLeft(void){
+  return SliceCount*(HOSTCLOCK/HOSTTICKHZ);
+}
+
+int32_t *OSPort_InitStack(int32_t *stackEnd, void(*thread)(void)){
+  osFrameType *frame;
+  // the frame only identifies the thread, align it for the host pointer
+  frame = (osFrameType *)(((uintptr_t)stackEnd - sizeof(osFrameType))&~(uintptr_t)7);
+  frame->pc = thread;
+  makethread(frame);
+  return (int32_t *)frame;
+}
+
+void OSPort_Launch(uint32_t theTimeSlice){
+  struct sigaction action;
+  struct itimerval timer;
+  SliceTicks = toticks(theTimeSlice);
+  SliceCount = SliceTicks;
+  Masked = 1;              // the first thread enables interrupts
+  TickPending = SwitchPending = 0;
+  action.sa_handler = alarmhandler;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, 0);
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = 1000000/HOSTTICKHZ;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_REAL, &timer, 0);
+  Current = lookup(RunPt);
+  swapcontext(&HostMain, &Current->context);
+  // never returns, a thread ends the process with exit()
+}
+
+void OSPort_Suspend(void){
+  SwitchPending = 1;
+  if(Masked == 0){
+    unmask();              // switch now, as the pended SysTick would
+  }
+}
+
+// bus cycles at HOSTCLOCK derived from the host monotonic clock
+void OSPort_CycleInit(void){
+}
+uint32_t OSPort_Cycles(void){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(((uint64_t)now.tv_sec*1000000000 + now.tv_nsec)*(HOSTCLOCK/1000000)/1000);
+}
+
+// no power modes on the host, wait for the next signal
+void OSPort_Idle(void){
+  pause();
+}
+
+// the sleep timer is the cycle counter; compares are only checked
+// on the HOSTTICKHZ tick, so OS_SleepUs has 1 ms resolution on the host
+void OSPort_TimerInit(void){
+}
+uint32_t OSPort_TimerNow(void){
+  return OSPort_Cycles();
+}
+void OSPort_TimerCompare(uint32_t when){
+  WakeTime = when;
+  WakeArmed = 1;
+  if((int32_t)(when - OSPort_TimerNow()) <= 0){
+    WakeArmed = 0;
+    WakePending = 1;       // taken when interrupts are enabled
+  }
+}
+void OSPort_TimerCancel(void){
+  WakeArmed = 0;
+}
+
+// the watchdog is checked every tick, a reset ends the process
+void OSPort_WatchdogInit(uint32_t timeout){
+  WatchdogFed = OSPort_Cycles();
+  WatchdogTimeout = timeout;
+}
+void OSPort_WatchdogFeed(void){
+  WatchdogFed = OSPort_Cycles();
+}
+
+//------------host.h------------
+void Host_StopTimer(void){
+  struct itimerval timer = {{0, 0}, {0, 0}};
+  setitimer(ITIMER_REAL, &timer, 0);
+  Masked = 1;
+}
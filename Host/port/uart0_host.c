@@ -0,0 +1,33 @@
+// uart0_host.c
+// Runs on a Linux host
+// UART0.h on stdout, so the kernel options that print out UART0
+// (OS_SEMSTATS, OS_DEADLOCK) build into kernelbench.
+// October 19, 2026
+
+#include <stdint.h>
+#include <stdio.h>
+#include "UART0.h"
+
+void UART0_Init(void){
+}
+
+void UART0_OutChar(char data){
+  if(data != '\r'){       // the target sends CR LF
+    putchar(data);
+  }
+}
+
+void UART0_OutString(char *pt){
+  while(*pt){
+    UART0_OutChar(*pt);
+    pt++;
+  }
+}
+
+void UART0_OutUDec(uint32_t n){
+  printf("%u", n);
+}
+
+void UART0_OutUHex(uint32_t number){
+  printf("%X", number);
+}
@@ -0,0 +1,61 @@
+// sqrttest.c
+// Runs on a Linux host
+// Checks sqrt32 of inc/Sqrt.c against floor(sqrt(s)) for every 32-bit
+// s, and compares it with the 16-iteration Newton's method sqrt32 the
+// labs used before, over the accelerometer range 0 to 3*1023^2.
+// Exit status is 1 if any result is wrong.
+// October 19, 2026
+// usage: sqrttest
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Sqrt.h"
+
+#define ACCELMAX (3*1023*1023)  // largest x*x+y*y+z*z of 10-bit axes
+
+// the old lab version; returns 0 and sets *divZero if t*t+s wraps to
+// a t of 0, where the target would divide by zero
+static uint32_t newton(uint32_t s, int *divZero){
+  uint32_t t;   // t*t will become s
+  int n;        // loop counter
+  t = s/16+1;   // initial guess
+  for(n = 16; n; --n){
+    if(t == 0){
+      *divZero = 1;
+      return 0;
+    }
+    t = ((t*t+s)/t)/2;
+  }
+  return t;
+}
+
+int main(void){
+  uint64_t s, r;
+  uint32_t errors = 0, newtonWrong = 0, firstDivZero = 0;
+  int divZero;
+  for(s=0; s<=UINT32_MAX; s++){
+    r = sqrt32((uint32_t)s);
+    if((r*r > s)||((r+1)*(r+1) <= s)){
+      if(errors < 10){
+        printf("sqrt32(%llu) = %llu is wrong\n", (unsigned long long)s, (unsigned long long)r);
+      }
+      errors++;
+    }
+    if(s <= ACCELMAX){
+      divZero = 0;
+      if(newton((uint32_t)s, &divZero) != r){
+        newtonWrong++;
+      }
+      if(divZero && (firstDivZero == 0)){
+        firstDivZero = (uint32_t)s;
+      }
+    }
+  }
+  printf("sqrt32: %u wrong of 2^32 inputs\n", errors);
+  printf("old Newton sqrt32: %u wrong of %u inputs up to 3*1023^2", newtonWrong, ACCELMAX + 1);
+  if(firstDivZero){
+    printf(", divides by zero from %u", firstDivZero);
+  }
+  printf("\n");
+  return errors != 0;
+}
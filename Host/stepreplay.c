@@ -0,0 +1,252 @@
+// stepreplay.c
+// Runs on a Linux host
+// Replays accelerometer traces through the step detector of
+// inc/StepDetect.c, the same source the labs build, and reports the
+// steps counted against the true count and how many samples per
+// second the detector runs on this host.  The -a, -n and -o lists are
+// tried in every combination, so a tuning change can be judged on
+// recorded walks before it goes on the board.
+// A trace is text, one sample per line, "x y z" as the 10-bit numbers
+// BSP_Accelerometer_Input returns, at the 10 Hz of Task1.  Lines that
+// start with # are comments; "# steps N" gives the true step count.
+// -g writes a synthetic walk in this format, for trying the tool out;
+// it is a sine on the magnitude plus noise, not a recording.
+// October 19, 2026
+// usage: stepreplay [-a alpha[,alpha...]] [-n count[,count...]]
+//                   [-o overshoot[,overshoot...]] [-s] [-t seconds] trace...
+//        stepreplay -g steps [-S seed] > trace
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "StepDetect.h"
+
+#define MAXTRACES 64
+
+struct trace{
+  const char *name;
+  uint32_t *squared;        // x*x+y*y+z*z per sample
+  uint32_t n;               // samples
+  int truth;                // true steps, -1 if the file does not say
+};
+struct trace Traces[MAXTRACES];
+int NumTraces;
+volatile uint32_t Sink;     // keeps the timed loop from being dropped
+
+static void usage(void){
+  fprintf(stderr,
+    "usage: stepreplay [-a alpha[,alpha...]] [-n count[,count...]]\n"
+    "                  [-o overshoot[,overshoot...]] [-s] [-t seconds] trace...\n"
+    "       stepreplay -g steps [-S seed] > trace\n"
+    "  -a  EWMA weight of a new sample out of 1024, default %d\n"
+    "  -n  samples to confirm a local min or max, default %d\n"
+    "  -o  crossing margin, default %d, or %d with -s\n"
+    "  -s  squared magnitudes, no sqrt32 per sample (STEPSQUARED in Lab4.c)\n"
+    "  -t  minimum time for the speed measurement, default 0.2 s\n"
+    "  -g  write a synthetic walk of this many steps and exit\n"
+    "  -S  seed for -g, default 1\n",
+    STEP_ALPHA, STEP_LOCALCOUNTTARGET, STEP_AVGOVERSHOOT, STEP_AVGOVERSHOOTSQ);
+  exit(2);
+}
+
+static void load(const char *name){
+  struct trace *t = &Traces[NumTraces];
+  FILE *f = fopen(name, "r");
+  char line[256];
+  uint32_t size = 1024;
+  unsigned x, y, z;
+  int n;
+  if(f == 0){
+    perror(name);
+    exit(1);
+  }
+  t->name = name;
+  t->squared = malloc(size*sizeof(uint32_t));
+  t->n = 0;
+  t->truth = -1;
+  while(fgets(line, sizeof(line), f)){
+    if(line[0] == '#'){
+      if(sscanf(line, "# steps %d", &n) == 1){
+        t->truth = n;
+      }
+    } else if(sscanf(line, "%u %u %u", &x, &y, &z) == 3){
+      if((x > 1023)||(y > 1023)||(z > 1023)){
+        fprintf(stderr, "%s: sample %u is not 10-bit\n", name, t->n + 1);
+        exit(1);
+      }
+      if(t->n == size){
+        size = 2*size;
+        t->squared = realloc(t->squared, size*sizeof(uint32_t));
+      }
+      t->squared[t->n] = x*x + y*y + z*z;
+      t->n++;
+    }
+  }
+  fclose(f);
+  if(t->n == 0){
+    fprintf(stderr, "%s: no samples\n", name);
+    exit(1);
+  }
+  NumTraces++;
+}
+
+// 0.7 to 1.0 s per step at 10 Hz, magnitude 900 +/- 60 and a little
+// noise on each axis, two seconds standing at each end
+static void stand(int samples){int i;
+  for(i=0; i<samples; i++){
+    printf("%d %d %d\n", 512 + rand()%7 - 3, 512 + rand()%7 - 3, 534 + rand()%7 - 3);
+  }
+}
+static void generate(int steps, uint32_t seed){
+  int i, k, half;
+  double m, x, y, z;
+  srand(seed);
+  printf("# synthetic walk, stepreplay -g %d -S %u\n", steps, seed);
+  printf("# steps %d\n", steps);
+  stand(20);
+  for(i=0; i<steps; i++){
+    half = 7 + rand()%4;       // samples in this step
+    for(k=0; k<half; k++){     // up on even steps, down on odd ones
+      m = 900 + ((i&1)? -60 : 60)*sin(M_PI*k/half);
+      x = 512 + rand()%7 - 3;
+      y = 512 + rand()%7 - 3;
+      z = sqrt(m*m - x*x - y*y) + rand()%7 - 3;
+      printf("%d %d %d\n", (int)x, (int)y, (int)z);
+    }
+  }
+  stand(20);
+}
+
+static void init(stepDetectType *pt, const struct trace *t, uint32_t mode,
+                 uint32_t alpha, uint32_t count, uint32_t overshoot){
+  StepDetect_Init(pt, mode, t->squared[0]);
+  pt->alpha = alpha;
+  pt->localCountTarget = count;
+  if(overshoot){
+    pt->overshoot = overshoot;
+  }
+}
+
+// steps counted on one trace, and samples per second over repeated replays
+static uint32_t replay(const struct trace *t, uint32_t mode, uint32_t alpha,
+                       uint32_t count, uint32_t overshoot, double seconds, double *rate){
+  stepDetectType detector;
+  struct timespec t0, t1;
+  double wall;
+  uint32_t i, steps;
+  uint64_t samples = 0;
+  init(&detector, t, mode, alpha, count, overshoot);
+  for(i=1; i<t->n; i++){
+    StepDetect_Put(&detector, t->squared[i]);
+  }
+  steps = detector.steps;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  do{
+    init(&detector, t, mode, alpha, count, overshoot);
+    for(i=1; i<t->n; i++){
+      StepDetect_Put(&detector, t->squared[i]);
+    }
+    Sink = detector.steps;
+    samples = samples + t->n - 1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec)/1e9;
+  } while(wall < seconds);
+  *rate = samples/wall;
+  return steps;
+}
+
+static void printerror(int steps, int truth){
+  if(truth > 0){
+    printf(" %6d %+7.1f%%", truth, 100.0*(steps - truth)/truth);
+  } else if(truth == 0){
+    printf(" %6d %8s", truth, "");
+  } else{
+    printf(" %6s %8s", "?", "");
+  }
+}
+
+int main(int argc, char *argv[]){
+  const char *alphas = 0, *counts = 0, *overshoots = "0";
+  uint32_t mode = STEP_MAGNITUDE, seed = 1;
+  double seconds = 0.2, rate, rateSum;
+  int c, i, gen = 0, steps, stepSum, truthSum;
+  char buf[16], *al, *a, *cl, *n, *ol, *o, *s1, *s2, *s3;
+  while((c = getopt(argc, argv, "a:n:o:st:g:S:")) != -1){
+    switch(c){
+      case 'a': alphas = optarg; break;
+      case 'n': counts = optarg; break;
+      case 'o': overshoots = optarg; break;
+      case 's': mode = STEP_SQUARED; break;
+      case 't': seconds = atof(optarg); break;
+      case 'g': gen = atoi(optarg); if(gen <= 0) usage(); break;
+      case 'S': seed = strtoul(optarg, 0, 0); break;
+      default: usage();
+    }
+  }
+  if(gen){
+    generate(gen, seed);
+    return 0;
+  }
+  if((optind == argc)||(argc - optind > MAXTRACES)){
+    usage();
+  }
+  for(i=optind; i<argc; i++){
+    load(argv[i]);
+  }
+  if(alphas == 0){
+    snprintf(buf, sizeof(buf), "%d", STEP_ALPHA);
+    alphas = strdup(buf);
+  }
+  if(counts == 0){
+    snprintf(buf, sizeof(buf), "%d", STEP_LOCALCOUNTTARGET);
+    counts = strdup(buf);
+  }
+  printf("%5s %5s %9s  %-24s %6s %6s %8s %10s\n",
+         "alpha", "count", "overshoot", "trace", "steps", "truth", "error", "samples/s");
+  al = strdup(alphas);
+  for(a = strtok_r(al, ",", &s1); a; a = strtok_r(0, ",", &s1)){
+    uint32_t alpha = strtoul(a, 0, 0);
+    if(alpha > 1023){
+      usage();
+    }
+    cl = strdup(counts);
+    for(n = strtok_r(cl, ",", &s2); n; n = strtok_r(0, ",", &s2)){
+      uint32_t count = strtoul(n, 0, 0);
+      ol = strdup(overshoots);
+      for(o = strtok_r(ol, ",", &s3); o; o = strtok_r(0, ",", &s3)){
+        uint32_t overshoot = strtoul(o, 0, 0);
+        stepDetectType shown;
+        stepSum = 0;
+        truthSum = 0;
+        rateSum = 0;
+        for(i=0; i<NumTraces; i++){
+          steps = replay(&Traces[i], mode, alpha, count, overshoot, seconds, &rate);
+          init(&shown, &Traces[i], mode, alpha, count, overshoot);
+          printf("%5u %5u %9u  %-24s %6d", alpha, count, shown.overshoot, Traces[i].name, steps);
+          printerror(steps, Traces[i].truth);
+          printf(" %10.3g\n", rate);
+          stepSum = stepSum + steps;
+          if((truthSum >= 0)&&(Traces[i].truth >= 0)){
+            truthSum = truthSum + Traces[i].truth;
+          } else{
+            truthSum = -1;
+          }
+          rateSum = rateSum + rate;
+        }
+        if(NumTraces > 1){
+          printf("%5u %5u %9u  %-24s %6d", alpha, count, shown.overshoot, "total", stepSum);
+          printerror(stepSum, truthSum);
+          printf(" %10.3g\n", rateSum/NumTraces);
+        }
+      }
+      free(ol);
+    }
+    free(cl);
+  }
+  free(al);
+  return 0;
+}
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+# trace2chrome.py
+# Runs on the development computer
+# Converts the binary kernel trace streamed out UART0 by Trace_Flush
+# (Lab4_Fitness_4C123/Trace.c) into Chrome trace JSON, which can be
+# opened in chrome://tracing or https://ui.perfetto.dev
+# October 19, 2026
+#
+# Capture the stream with any terminal program that can log raw bytes,
+# for example on Linux
+#   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > trace.bin
+# then convert it
+#   python3 trace2chrome.py trace.bin -o trace.json \
+#       --map ../Lab4_Fitness_4C123/Listings/Lab4.map
+
+import argparse
+import json
+import re
+import sys
+
+# event types, same numbers as Trace.h
+SYNC, SWITCH, WAIT, BLOCK, SIGNAL, ISRENTER, ISREXIT, FIFODROP, LOST = range(9)
+ISRNAMES = {0: "runperiodicevents", 1: "RealTimeEvents", 2: "GPIOPortD_Handler",
+            3: "WakeupHandler"}
+ISRTID = 100          # Chrome thread id used for the interrupt track
+SRAMBASE = 0x20000000
+
+
+def readvarint(data, i):
+    n = 0
+    shift = 0
+    while True:
+        if i >= len(data):
+            raise IndexError
+        b = data[i]
+        i += 1
+        n |= (b & 0x7F) << shift
+        shift += 7
+        if b < 0x80:
+            return n, i
+
+
+def parse(data):
+    """Yield (time, type, thread, arg) with time unwrapped to 64 bits."""
+    i = 0
+    now = None
+    while i + 3 <= len(data):
+        if data[i] != ord('T') or data[i + 1] != ord('R'):
+            i += 1                       # resynchronize on the next frame
+            continue
+        count = data[i + 2]
+        j = i + 3
+        events = []
+        try:
+            for k in range(count):
+                head = data[j]
+                kind = head >> 4
+                thread = head & 0x0F
+                j += 1
+                if kind == SYNC:
+                    stamp = int.from_bytes(data[j:j + 4], "little")
+                    j += 4
+                    _, j = readvarint(data, j)
+                    if k != 0:
+                        raise ValueError
+                    if now is None:
+                        now = stamp
+                    else:
+                        # extend the 32-bit counter, it wraps every 53 s at 80 MHz
+                        now += (stamp - now) & 0xFFFFFFFF
+                    continue
+                delta, j = readvarint(data, j)
+                arg, j = readvarint(data, j)
+                now += delta
+                events.append((now, kind, thread, arg))
+        except (IndexError, ValueError):
+            i += 1                       # corrupt or truncated frame
+            continue
+        for event in events:
+            yield event
+        i = j
+
+
+def readmap(name):
+    """Map SRAM offsets to data symbol names using a Keil .map file."""
+    symbols = {}
+    pattern = re.compile(r"^\s+(\w+)\s+0x([0-9a-fA-F]{8})\s+Data\s+\d+")
+    with open(name, errors="replace") as mapfile:
+        for line in mapfile:
+            match = pattern.match(line)
+            if match:
+                address = int(match.group(2), 16)
+                if address >= SRAMBASE:
+                    symbols[(address - SRAMBASE) & 0xFFFF] = match.group(1)
+    return symbols
+
+
+def convert(events, clock, threadnames, symbols):
+    out = []
+    us = 1e6 / clock
+
+    def semname(arg):
+        return symbols.get(arg, "0x%08X" % (SRAMBASE + arg))
+
+    def threadname(n):
+        if n < len(threadnames):
+            return threadnames[n]
+        return "Thread%d" % n
+
+    running = None   # (thread, start time)
+    first = None
+    for time, kind, thread, arg in events:
+        if first is None:
+            first = time
+        ts = (time - first) * us
+        if kind == SWITCH:
+            if running is not None:
+                name, start = running
+                out.append({"name": threadname(name), "ph": "X", "pid": 1,
+                            "tid": name, "ts": start, "dur": ts - start})
+            running = (thread, ts)
+        elif kind in (WAIT, BLOCK, SIGNAL):
+            label = {WAIT: "OS_Wait", BLOCK: "blocked", SIGNAL: "OS_Signal"}[kind]
+            out.append({"name": "%s %s" % (label, semname(arg)), "ph": "i",
+                        "s": "t", "pid": 1, "tid": thread, "ts": ts,
+                        "args": {"semaphore": semname(arg)}})
+        elif kind in (ISRENTER, ISREXIT):
+            out.append({"name": ISRNAMES.get(arg, "ISR%d" % arg),
+                        "ph": "B" if kind == ISRENTER else "E",
+                        "pid": 1, "tid": ISRTID, "ts": ts})
+        elif kind == FIFODROP:
+            out.append({"name": "FIFO full", "ph": "i", "s": "g", "pid": 1,
+                        "tid": thread, "ts": ts})
+            out.append({"name": "LostData", "ph": "C", "pid": 1, "ts": ts,
+                        "args": {"LostData": arg}})
+        elif kind == LOST:
+            out.append({"name": "trace overflow (%d lost)" % arg, "ph": "i",
+                        "s": "g", "pid": 1, "tid": ISRTID, "ts": ts})
+    names = set(e["tid"] for e in out if "tid" in e)
+    for tid in sorted(names):
+        label = "interrupts" if tid == ISRTID else threadname(tid)
+        out.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                    "args": {"name": label}})
+    out.append({"name": "process_name", "ph": "M", "pid": 1,
+                "args": {"name": "TM4C123"}})
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert a kernel trace to Chrome trace JSON")
+    parser.add_argument("input", help="raw bytes captured from UART0")
+    parser.add_argument("-o", "--output", default="-",
+                        help="Chrome trace JSON file (default stdout)")
+    parser.add_argument("--clock", type=float, default=80e6,
+                        help="core clock in Hz (default 80e6)")
+    parser.add_argument("--names", default="Task0,Task1,Task2,Task3,Task4,Task5,Task6,Task7",
+                        help="comma separated thread names in tcbs[] order")
+    parser.add_argument("--map", help="Keil .map file used to name semaphores")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as infile:
+        data = infile.read()
+    symbols = readmap(args.map) if args.map else {}
+    trace = convert(parse(data), args.clock, args.names.split(","), symbols)
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as outfile:
+            json.dump(trace, outfile)
+
+
+if __name__ == "__main__":
+    main()
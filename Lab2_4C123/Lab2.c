@@ -38,9 +38,10 @@
 #include "../inc/Profile.h"
 #include "Texas.h"
 #include "../inc/CortexM.h"
+#include "../inc/RunStats.h"
+#include "../inc/StepDetect.h"
 #include "os.h"
 
-uint32_t sqrt32(uint32_t s);
 #define THREADFREQ 1000   // frequency in Hz of round robin scheduler
 
 //---------------- Global variables shared between tasks ----------------
@@ -51,6 +52,7 @@ uint32_t Magnitude;         // will not overflow (3*1,023^2 = 3,139,587)
 uint32_t EWMA;              // https://en.wikipedia.org/wiki/Moving_average#Exponential_moving_average
 uint16_t SoundData;         // raw data sampled from the microphone
 int32_t SoundAvg;
+uint32_t SoundRMS;          // Root Mean Square average of most recent sound samples
 
 uint32_t LightData;
 int32_t TemperatureData;    // 0.1C
@@ -78,8 +80,8 @@ enum plotstate PlotState = Accelerometer;
 
 //---------------- Task0 samples sound from microphone ----------------
 // Event thread run by OS in real time at 1000 Hz
-#define SOUNDRMSLENGTH 1000 // number of samples to collect before calculating RMS (may overflow if greater than 4104)
-int16_t SoundArray[SOUNDRMSLENGTH];
+#define SOUNDRMSLENGTH 1000 // number of samples in each RMS, up to 65536
+runStatsType Sound;         // running sums of the samples so far, see RunStats.h
 // *********Task0_Init*********
 // initializes microphone
 // Task0 measures sound intensity
@@ -87,6 +89,7 @@ int16_t SoundArray[SOUNDRMSLENGTH];
 // Outputs: none
 void Task0_Init(void){
   BSP_Microphone_Init();
+  RunStats_Init(&Sound, 0, 0);  // running total, reset every SOUNDRMSLENGTH
 }
 // *********Task0*********
 // Periodic event thread runs in real time at 1000 Hz
@@ -94,21 +97,16 @@ void Task0_Init(void){
 // Inputs:  none
 // Outputs: none
 void Task0(void){
-  static int32_t soundSum = 0;
-  static int time = 0; // units of microphone sampling rate
-
   TExaS_Task0();     // record system time in array, toggle virtual logic analyzer
   Profile_Toggle0(); // viewed by a real logic analyzer to know Task0 started
   // ADC is shared, but on the TM4C123 it is not critical with other ADC inputs
   BSP_Microphone_Input(&SoundData);
-  soundSum = soundSum + (int32_t)SoundData;
-  SoundArray[time] = SoundData;
-  time = time + 1;
-  if(time == SOUNDRMSLENGTH){
-    SoundAvg = soundSum/SOUNDRMSLENGTH;
-    soundSum = 0;
+  RunStats_Put(&Sound, SoundData);
+  if(Sound.count == SOUNDRMSLENGTH){
+    SoundAvg = RunStats_Mean(&Sound);
+    SoundRMS = RunStats_RMS(&Sound);
+    RunStats_Reset(&Sound);
     OS_Signal(&NewData); // makes task5 run every 1 sec
-    time = 0;
   }
 }
 /* ****************************************** */
@@ -118,6 +116,7 @@ void Task0(void){
 //---------------- Task1 measures acceleration ----------------
 // Event thread run by OS in real time at 10 Hz
 uint16_t AccX, AccY, AccZ;  // returned by BSP as 10-bit numbers
+stepDetectType StepDetector; // step counter, see StepDetect.h for the algorithm and its parameters
 // *********Task1_Init*********
 // initializes accelerometer
 // Task1 counts Steps
@@ -127,8 +126,9 @@ void Task1_Init(void){
   BSP_Accelerometer_Init();
   // initialize the exponential weighted moving average filter
   BSP_Accelerometer_Input(&AccX, &AccY, &AccZ);
-  Magnitude = sqrt32(AccX*AccX + AccY*AccY + AccZ*AccZ);
-  EWMA = Magnitude;                // this is a guess; there are many options
+  StepDetect_Init(&StepDetector, STEP_MAGNITUDE, AccX*AccX + AccY*AccY + AccZ*AccZ);
+  Magnitude = StepDetect_Magnitude(&StepDetector);
+  EWMA = StepDetect_Average(&StepDetector);
   Steps = 0;
 }
 // *********Task1*********
@@ -154,20 +154,8 @@ void Task1(void){uint32_t squared;
 // Main thread scheduled by OS round robin preemptive scheduler
 // accepts data from accelerometer, calculates steps, plots on LCD, and output to LED
 // If no data are lost, the main loop in Task2 runs exactly at 10 Hz, but not in real time
-enum state{                 // the step counting algorithm cycles through four states
-  LookingForMax,            // looking for a local maximum in current magnitude
-  LookingForCross1,         // looking for current magnitude to cross average magnitude, minus a constant
-  LookingForMin,            // looking for a local minimum in current magnitude
-  LookingForCross2          // looking for current magnitude to cross average magnitude, plus a constant
-};
-enum state AlgorithmState = LookingForMax;
-#define LOCALCOUNTTARGET 5  // The number of valid measured magnitudes needed to confirm a local min or local max.  Increase this number for longer strides or more frequent measurements.
-#define AVGOVERSHOOT 25     // The amount above or below average a measurement must be to count as "crossing" the average.  Increase this number to reject increasingly hard shaking as steps.
 #define ACCELERATION_MAX 1400
 #define ACCELERATION_MIN 600
-#define ALPHA 128           // The degree of weighting decrease, a constant smoothing factor between 0 and 1,023. A higher ALPHA discounts older observations faster.
-                            // basic step counting algorithm is based on a forum post from
-                            // http://stackoverflow.com/questions/16392142/android-accelerometer-profiling/16539643#16539643
 #define SOUND_MAX 900
 #define SOUND_MIN 300
 #define LIGHT_MAX 200000
@@ -186,66 +174,15 @@ void drawaxes(void){
   OS_Signal(&LCDmutex);  ReDrawAxes = 0;
 }
 void Task2(void){uint32_t data;
-  uint32_t localMin;   // smallest measured magnitude since odd-numbered step detected
-  uint32_t localMax;   // largest measured magnitude since even-numbered step detected
-  uint32_t localCount; // number of measured magnitudes above local min or below local max
-  localMin = 1024;
-  localMax = 0;
-  localCount = 0;
   drawaxes();
   while(1){
     data = OS_MailBox_Recv(); // acceleration data from Task 1
     TExaS_Task2();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle2(); // viewed by a real logic analyzer to know Task2 started
-    Magnitude = sqrt32(data);
-    EWMA = (ALPHA*Magnitude + (1023 - ALPHA)*EWMA)/1024;
-    if(AlgorithmState == LookingForMax){
-      if(Magnitude > localMax){
-        localMax = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross1;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross1){
-      if(Magnitude > localMax){
-      // somehow measured a very large magnitude
-        localMax = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      } else if(Magnitude < (EWMA -  AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMin = 1024;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      }
-    } else if(AlgorithmState == LookingForMin){
-      if(Magnitude < localMin){
-        localMin = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross2;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross2){
-      if(Magnitude < localMin){
-      // somehow measured a very small magnitude
-        localMin = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      } else if(Magnitude > (EWMA + AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMax = 0;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      }
-    }
+    StepDetect_Put(&StepDetector, data);
+    Steps = StepDetector.steps;
+    Magnitude = StepDetect_Magnitude(&StepDetector);
+    EWMA = StepDetect_Average(&StepDetector);
     if(ReDrawAxes){
       drawaxes();
       ReDrawAxes = 0;
@@ -262,7 +199,7 @@ void Task2(void){uint32_t data;
     BSP_LCD_PlotIncrement();
     OS_Signal(&LCDmutex);
     // update the LED
-    switch(AlgorithmState){
+    switch(StepDetector.state){
       case LookingForMax: BSP_RGB_Set(500, 0, 0); break;
       case LookingForCross1: BSP_RGB_Set(350, 350, 0); break;
       case LookingForMin: BSP_RGB_Set(0, 500, 0); break;
@@ -366,8 +303,7 @@ void Task4(void){int32_t voltData,tempData;
 // updates the text at the top of the LCD
 // Inputs:  none
 // Outputs: none
-void Task5(void){int32_t soundSum;
-  uint32_t soundRMS;        // Root Mean Square average of most recent sound samples
+void Task5(void){
   OS_Wait(&LCDmutex);
   BSP_LCD_DrawString(0, 0,  "Time=",  TOPTXTCOLOR);
   BSP_LCD_DrawString(0, 1,  "Step=",  TOPTXTCOLOR);
@@ -378,16 +314,11 @@ void Task5(void){int32_t soundSum;
     OS_Wait(&NewData);
     TExaS_Task5();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle5(); // viewed by a real logic analyzer to know Task5 started
-    soundSum = 0;
-    for(int i=0; i<SOUNDRMSLENGTH; i=i+1){
-      soundSum = soundSum + (SoundArray[i] - SoundAvg)*(SoundArray[i] - SoundAvg);
-    }
-    soundRMS = sqrt32(soundSum/SOUNDRMSLENGTH);
     OS_Wait(&LCDmutex);
     BSP_LCD_SetCursor(5,  0); BSP_LCD_OutUDec4(Time/10,       TOPNUMCOLOR);
     BSP_LCD_SetCursor(5,  1); BSP_LCD_OutUDec4(Steps,         MAGCOLOR);
     BSP_LCD_SetCursor(16, 0); BSP_LCD_OutUFix2_1(TemperatureData, TEMPCOLOR);
-    BSP_LCD_SetCursor(16, 1); BSP_LCD_OutUDec4(soundRMS,      SOUNDCOLOR);
+    BSP_LCD_SetCursor(16, 1); BSP_LCD_OutUDec4(SoundRMS,      SOUNDCOLOR);
     OS_Signal(&LCDmutex);
   }
 }
@@ -522,15 +453,3 @@ int main_step5(void){
   OS_Launch(BSP_Clock_GetFreq()/THREADFREQ); // doesn't return, interrupts enabled in here
   return 0;             // this never executes
 }
-// Newton's method
-// s is an integer
-// sqrt(s) is an integer
-uint32_t sqrt32(uint32_t s){
-uint32_t t;   // t*t will become s
-int n;             // loop counter
-  t = s/16+1;      // initial guess
-  for(n = 16; n; --n){ // will finish
-    t = ((t*t+s)/t)/2;
-  }
-  return t;
-}
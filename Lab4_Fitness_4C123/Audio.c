@@ -0,0 +1,75 @@
+// Audio.c
+// Runs on TM4C123
+// Block audio pipeline: DC removal, RMS and peak hold, see Audio.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Audio.h"
+#include "Sqrt.h"
+
+// ******** Audio_Init ************
+// Start a pipeline with the DC tracker at midscale
+// Inputs:  pt, pipeline state
+//          window, samples per RMS result
+//          holdWindows, results a peak is held for
+// Outputs: none
+void Audio_Init(audioType *pt, uint32_t window, uint32_t holdWindows){
+  pt->dc = 2048<<16;          // microphone is biased at half of 3.3 V
+  pt->sumSq = 0;
+  pt->count = 0;
+  pt->peak = 0;
+  pt->window = window;
+  pt->holdWindows = holdWindows;
+  pt->holdCount = 0;
+  pt->rms = 0;
+  pt->peakHold = 0;
+  pt->mean = 2048;
+}
+
+// ******** Audio_Block ************
+// Remove DC from a block and add it to the RMS and peak of the window
+// Inputs:  pt, pipeline state
+//          x, n 12-bit samples
+// Outputs: 1 if the window ended and the results are new, 0 if not
+int Audio_Block(audioType *pt, const uint16_t *x, uint32_t n){
+  int32_t dc = pt->dc;
+  int32_t ac;
+  uint32_t peak = pt->peak;
+  uint32_t sumSq, i, len;
+  pt->count += n;
+  while(n){
+    len = (n > AUDIOBLOCKMAX) ? AUDIOBLOCKMAX : n;
+    sumSq = 0;
+    for(i=0; i<len; i++){
+      dc = dc + ((((int32_t)x[i]<<16) - dc)>>AUDIODCSHIFT);
+      ac = (int32_t)x[i] - (dc>>16);
+      if(ac < 0){
+        ac = -ac;
+      }
+      sumSq = sumSq + (uint32_t)(ac*ac);
+      if((uint32_t)ac > peak){
+        peak = ac;
+      }
+    }
+    pt->sumSq += sumSq;
+    x = x + len;
+    n = n - len;
+  }
+  pt->dc = dc;
+  pt->peak = peak;
+  if(pt->count < pt->window){
+    return 0;
+  }
+  pt->rms = sqrt32((uint32_t)(pt->sumSq/pt->count)); // mean square < 2^24
+  if((peak >= pt->peakHold)||(pt->holdCount == 0)){
+    pt->peakHold = peak;
+    pt->holdCount = pt->holdWindows;
+  } else{
+    pt->holdCount--;
+  }
+  pt->mean = dc>>16;
+  pt->sumSq = 0;
+  pt->count = 0;
+  pt->peak = 0;
+  return 1;
+}
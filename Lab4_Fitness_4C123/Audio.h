@@ -0,0 +1,48 @@
+// Audio.h
+// Runs on TM4C123
+// Block processing of microphone samples at any sampling rate, for
+// blocks from MicDMA: DC removal, RMS and peak hold.  A one-pole
+// tracker follows the DC level, and each DC-free sample is squared
+// into a sum of squares.  The sum within a block is 32 bits, which
+// cannot overflow for AUDIOBLOCKMAX 12-bit samples, and the sum over
+// a window is 64 bits, so a window can be any number of samples
+// (one second at 16 kHz is 16000).
+// October 19, 2026
+
+#ifndef __AUDIO_H
+#define __AUDIO_H  1
+
+#define AUDIOBLOCKMAX 256 // samples per 32-bit block sum, 256*4095^2 < 2^32
+#define AUDIODCSHIFT 10   // DC tracker time constant, 2^10 samples
+
+struct audio{
+  int32_t dc;             // DC level in 1/65536 ADC units
+  uint64_t sumSq;         // sum of squares of DC-free samples this window
+  uint32_t count;         // samples this window
+  uint32_t peak;          // largest |DC-free sample| this window
+  uint32_t window;        // samples per result, checked at the end of each block
+  uint32_t holdWindows;   // windows a peak is held
+  uint32_t holdCount;     // windows left for the held peak
+  // results, updated when Audio_Block returns 1
+  uint32_t rms;           // RMS of the DC-free samples, ADC units
+  uint32_t peakHold;      // held peak, ADC units
+  int32_t mean;           // DC level, ADC units
+};
+typedef struct audio audioType;
+
+// ******** Audio_Init ************
+// Start a pipeline with the DC tracker at midscale
+// Inputs:  pt, pipeline state
+//          window, samples per RMS result, rounded up to whole blocks
+//          holdWindows, results a peak is held for before it may fall
+// Outputs: none
+void Audio_Init(audioType *pt, uint32_t window, uint32_t holdWindows);
+
+// ******** Audio_Block ************
+// Remove DC from a block and add it to the RMS and peak of the window
+// Inputs:  pt, pipeline state
+//          x, n 12-bit samples
+// Outputs: 1 if the window ended and rms, peakHold and mean are new, 0 if not
+int Audio_Block(audioType *pt, const uint16_t *x, uint32_t n);
+
+#endif
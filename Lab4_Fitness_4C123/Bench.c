@@ -0,0 +1,438 @@
+// Bench.c
+// Runs on TM4C123
+// Kernel microbenchmarks, see Bench.h.
+// Each measurement is BENCHSAMPLES samples of the bus cycles between
+// two reads of the DWT cycle counter, less the cost of the reads.
+//   switch       OS_Suspend in one thread to running in another
+//   scheduler    Scheduler alone, with the other threads blocked
+//   waitsignal   OS_Signal then OS_Wait in one thread, no blocking
+//   pingpong     OS_Signal/OS_Wait round trip between two threads
+//   fifopair     OS_FIFO_Put then OS_FIFO_Get in one thread
+//   fifohandoff  OS_FIFO_Put in one thread to OS_FIFO_Get returning in another
+//   sleep1       OS_Sleep(1) call to return, 80000 is exactly 1 ms
+//   sleepus100   OS_SleepUs(100) call to return, 8000 is exactly 100 us
+// and the block kernels of DSP.h on DSPLENGTH samples, against the
+// scalar loop Task5 ran over SoundArray before RunStats.h:
+//   sumsqloop    sum of (x[i]-avg)^2, one multiply-accumulate per sample
+//   dspsum       DSP_Sum
+//   dspsumsq     DSP_SumSq
+//   dspdot       DSP_Dot
+//   dspminmax    DSP_MinMax
+// then dspcheck compares the four kernels with one-sample loops at
+// every start offset 0-3 and length 0 to DSPLENGTH-3, on full range
+// samples, so the SMLAD/SMLALD path is checked where it runs
+// (Host/dsptest.c does the same for the C path)
+// With OS_SRP (Srp.h), srpcheck releases a level 1 job that locks a
+// resource whose ceiling is 3, and from inside the lock releases a
+// level 3 job that uses it and a level 4 job that does not: the
+// level 4 job must run at once, the level 3 one only at Srp_Unlock
+// October 19, 2026
+
+#include <stdint.h>
+#include "Bench.h"
+#include "os.h"
+#include "osport.h"
+#include "BSP.h"
+#include "CortexM.h"
+#include "UART0.h"
+#include "DSP.h"
+#include "Srp.h"
+
+#define THREADFREQ 1000   // frequency in Hz of round robin scheduler
+
+// kernel symbols, the TCB is private to os.c
+struct tcb;
+extern struct tcb *RunPt;
+void Scheduler(void);
+
+uint32_t Samples[BENCHSAMPLES];
+uint32_t SampleN;         // number of Samples[] filled
+uint32_t Stamp;           // cycle count before the operation
+uint32_t Overhead;        // cycles for two back-to-back OSPort_Cycles calls
+int32_t StartSwitch, StartPing, StartFifo, Done;
+int32_t Ping, Pong, FifoAck, Dummy;
+#define DSPLENGTH 1000    // samples per block, the old SOUNDRMSLENGTH
+int16_t DspX[DSPLENGTH] __attribute__((aligned(4)));
+int16_t DspY[DSPLENGTH] __attribute__((aligned(4)));
+volatile int64_t DspResult; // keeps the compiler from dropping a kernel
+int16_t DspMin, DspMax;
+
+static void store(uint32_t now){
+  if(SampleN < BENCHSAMPLES){
+    Samples[SampleN] = now - Stamp - Overhead;
+    SampleN++;
+  }
+}
+
+// two copies at the same priority yield to each other
+void SwitchThread(void){uint32_t now;
+  while(1){
+    OS_Wait(&StartSwitch);
+    while(SampleN < BENCHSAMPLES){
+      Stamp = OSPort_Cycles();
+      OS_Suspend();
+      now = OSPort_Cycles();
+      store(now);
+    }
+    OS_Signal(&Done);
+  }
+}
+
+void PingThread(void){uint32_t now;
+  while(1){
+    OS_Wait(&StartPing);
+    while(SampleN < BENCHSAMPLES){
+      Stamp = OSPort_Cycles();
+      OS_Signal(&Ping);
+      OS_Wait(&Pong);
+      now = OSPort_Cycles();
+      store(now);
+    }
+    OS_Signal(&Done);
+  }
+}
+void PongThread(void){
+  while(1){
+    OS_Wait(&Ping);
+    OS_Signal(&Pong);
+  }
+}
+
+void Producer(void){
+  while(1){
+    OS_Wait(&StartFifo);
+    while(SampleN < BENCHSAMPLES){
+      Stamp = OSPort_Cycles();
+      OS_FIFO_Put(SampleN);
+      OS_Wait(&FifoAck);  // let the consumer run
+    }
+    OS_Signal(&Done);
+  }
+}
+void Consumer(void){uint32_t now;
+  while(1){
+    OS_Wait(&StartFifo);
+    while(SampleN < BENCHSAMPLES){
+      OS_FIFO_Get();
+      now = OSPort_Cycles();
+      store(now);
+      OS_Signal(&FifoAck);
+    }
+    OS_Signal(&Done);
+  }
+}
+
+// print n right justified in a field of width characters
+static void outudec(uint32_t n, int width){
+  char buf[10];
+  int i = 0;
+  do{
+    buf[i] = '0' + n%10;
+    n = n/10;
+    i++;
+  } while(n);
+  while(width > i){
+    UART0_OutChar(' ');
+    width--;
+  }
+  while(i){
+    i--;
+    UART0_OutChar(buf[i]);
+  }
+}
+
+// sort Samples[] and print one line: name min median max
+static void report(char *name){
+  uint32_t i, j, x;
+  int n = 0;
+  for(i=1; i<BENCHSAMPLES; i++){  // insertion sort
+    x = Samples[i];
+    for(j=i; (j>0)&&(Samples[j-1] > x); j--){
+      Samples[j] = Samples[j-1];
+    }
+    Samples[j] = x;
+  }
+  while(name[n]){
+    UART0_OutChar(name[n]);
+    n++;
+  }
+  while(n < 12){
+    UART0_OutChar(' ');
+    n++;
+  }
+  outudec(Samples[0], 9);
+  outudec(Samples[BENCHSAMPLES/2], 9);
+  outudec(Samples[BENCHSAMPLES-1], 9);
+  UART0_OutString("\r\n");
+}
+
+// 12-bit microphone-like samples around midscale
+static void dspfill(void){int i;
+  uint32_t seed = 1;
+  for(i=0; i<DSPLENGTH; i++){
+    seed = 1664525*seed + 1013904223;
+    DspX[i] = 1848 + (seed>>23);  // 1848 to 2359
+    DspY[i] = 1848 + ((seed>>7)&0x1FF);
+  }
+}
+
+// time the block kernels
+static void dspbench(void){uint32_t now;
+  int32_t avg, sum;
+  int i;
+  dspfill();
+  avg = DSP_Sum(DspX, DSPLENGTH)/DSPLENGTH;
+  for(SampleN=0; SampleN<BENCHSAMPLES; ){
+    Stamp = OSPort_Cycles();
+    sum = 0;
+    for(i=0; i<DSPLENGTH; i=i+1){
+      sum = sum + (DspX[i] - avg)*(DspX[i] - avg);
+    }
+    now = OSPort_Cycles();
+    store(now);
+    DspResult = sum;
+  }
+  report("sumsqloop");
+  for(SampleN=0; SampleN<BENCHSAMPLES; ){
+    Stamp = OSPort_Cycles();
+    DspResult = DSP_Sum(DspX, DSPLENGTH);
+    now = OSPort_Cycles();
+    store(now);
+  }
+  report("dspsum");
+  for(SampleN=0; SampleN<BENCHSAMPLES; ){
+    Stamp = OSPort_Cycles();
+    DspResult = DSP_SumSq(DspX, DSPLENGTH);
+    now = OSPort_Cycles();
+    store(now);
+  }
+  report("dspsumsq");
+  for(SampleN=0; SampleN<BENCHSAMPLES; ){
+    Stamp = OSPort_Cycles();
+    DspResult = DSP_Dot(DspX, DspY, DSPLENGTH);
+    now = OSPort_Cycles();
+    store(now);
+  }
+  report("dspdot");
+  for(SampleN=0; SampleN<BENCHSAMPLES; ){
+    Stamp = OSPort_Cycles();
+    DSP_MinMax(DspX, DSPLENGTH, &DspMin, &DspMax);
+    now = OSPort_Cycles();
+    store(now);
+  }
+  report("dspminmax");
+}
+
+// the block kernels against one-sample loops, prints dspcheck ok
+// or the number of wrong results
+static void dspcheck(void){
+  uint32_t seed = 1, i, n, offset, errors = 0;
+  const int16_t *x, *y;
+  int32_t sum;
+  uint64_t sumSq;
+  int64_t dot;
+  int16_t lo, hi, min, max;
+  for(i=0; i<DSPLENGTH; i++){
+    seed = 1664525*seed + 1013904223;
+    DspX[i] = (int16_t)(seed>>16);  // -32768 to 32767
+    DspY[i] = (int16_t)seed;
+  }
+  for(offset=0; offset<4; offset++){
+    x = &DspX[offset];
+    y = &DspY[offset^1];            // one of x and y misaligned
+    for(n=0; n<=DSPLENGTH-3; n++){
+      sum = 0;
+      sumSq = 0;
+      dot = 0;
+      for(i=0; i<n; i++){
+        sum += x[i];
+        sumSq += (uint32_t)(x[i]*x[i]);
+        dot += x[i]*y[i];
+      }
+      if(DSP_Sum(x, n) != sum) errors++;
+      if(DSP_SumSq(x, n) != sumSq) errors++;
+      if(DSP_Dot(x, y, n) != dot) errors++;
+      if(DSP_Dot(x, x, n) != (int64_t)sumSq) errors++;   // aligned pair when offset is even
+      if(n){
+        lo = hi = x[0];
+        for(i=1; i<n; i++){
+          if(x[i] < lo) lo = x[i];
+          if(x[i] > hi) hi = x[i];
+        }
+        DSP_MinMax(x, n, &min, &max);
+        if((min != lo)||(max != hi)) errors++;
+      }
+    }
+  }
+  if(errors){
+    UART0_OutString("dspcheck    FAIL ");
+    outudec(errors, 0);
+    UART0_OutString(" wrong\r\n");
+  } else{
+    UART0_OutString("dspcheck    ok\r\n");
+  }
+}
+
+#if OS_SRP
+srpJobType SrpLow, SrpMid, SrpTop;
+srpResourceType SrpRes;   // used by SrpLow and SrpMid, ceiling 3
+uint32_t SrpMidRuns, SrpTopRuns;
+uint32_t SrpErrors;
+static void srplow(void){uint32_t previous;
+  previous = Srp_Lock(&SrpRes);
+  Srp_Release(&SrpMid);   // level 3, not above the ceiling: waits
+  if(SrpMidRuns != 0) SrpErrors++;
+  Srp_Release(&SrpTop);   // level 4, above the ceiling: runs now
+  if(SrpTopRuns != 1) SrpErrors++;
+  if(SrpMidRuns != 0) SrpErrors++;
+  Srp_Unlock(previous);   // SrpMid runs here, before Srp_Unlock returns
+  if(SrpMidRuns != 1) SrpErrors++;
+}
+static void srpmid(void){uint32_t previous;
+  previous = Srp_Lock(&SrpRes);
+  SrpMidRuns++;
+  Srp_Unlock(previous);
+}
+static void srptop(void){
+  SrpTopRuns++;
+}
+
+// ceiling blocking of SRP jobs, prints srpcheck ok or the number of
+// wrong orders, and the words of SrpStack used
+static void srpcheck(void){
+  SrpMidRuns = SrpTopRuns = SrpErrors = 0;
+  Srp_Release(&SrpLow);   // level 1 preempts this thread, done on return
+  if((SrpMidRuns != 1)||(SrpTopRuns != 1)) SrpErrors++;
+  if(SrpErrors){
+    UART0_OutString("srpcheck    FAIL ");
+    outudec(SrpErrors, 0);
+    UART0_OutString(" wrong");
+  } else{
+    UART0_OutString("srpcheck    ok");
+  }
+  UART0_OutString(", SrpStack ");
+  outudec(Srp_StackUsed(), 0);
+  UART0_OutString(" words\r\n");
+}
+#endif
+
+// release n worker threads waiting on start and wait for all of them
+static void run(int32_t *start, int n){int i;
+  SampleN = 0;
+  for(i=0; i<n; i++){
+    OS_Signal(start);
+  }
+  for(i=0; i<n; i++){
+    OS_Wait(&Done);
+  }
+}
+
+// highest priority, runs each benchmark in turn
+void Controller(void){uint32_t now;
+  struct tcb *self;
+  while(1){
+    UART0_OutString("name              min   median      max  bus cycles, ");
+    outudec(BENCHSAMPLES, 0);
+    UART0_OutString(" samples\r\n");
+    Overhead = 0;
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){
+      Stamp = OSPort_Cycles();
+      now = OSPort_Cycles();
+      store(now);
+    }
+    report("empty");      // not subtracted from itself
+    Overhead = Samples[0];
+
+    run(&StartSwitch, 2);
+    report("switch");
+
+    DisableInterrupts();  // Scheduler picks this thread again, no switch
+    self = RunPt;
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){
+      Stamp = OSPort_Cycles();
+      Scheduler();
+      now = OSPort_Cycles();
+      store(now);
+    }
+    RunPt = self;
+    EnableInterrupts();
+    report("scheduler");
+
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){
+      Stamp = OSPort_Cycles();
+      OS_Signal(&Dummy);
+      OS_Wait(&Dummy);
+      now = OSPort_Cycles();
+      store(now);
+    }
+    report("waitsignal");
+
+    run(&StartPing, 1);
+    report("pingpong");
+
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){  // Consumer is not in OS_FIFO_Get
+      Stamp = OSPort_Cycles();
+      OS_FIFO_Put(0);
+      OS_FIFO_Get();
+      now = OSPort_Cycles();
+      store(now);
+    }
+    report("fifopair");
+
+    run(&StartFifo, 2);
+    report("fifohandoff");
+
+    OS_Sleep(1);          // start just after a sleep tick
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){
+      Stamp = OSPort_Cycles();
+      OS_Sleep(1);
+      now = OSPort_Cycles();
+      store(now);
+    }
+    report("sleep1");
+
+    for(SampleN=0; SampleN<BENCHSAMPLES; ){
+      Stamp = OSPort_Cycles();
+      OS_SleepUs(100);
+      now = OSPort_Cycles();
+      store(now);
+    }
+    report("sleepus100");
+    dspbench();
+    dspcheck();
+#if OS_SRP
+    srpcheck();
+#endif
+    UART0_OutString("\r\n");
+    OS_Sleep(1000);
+  }
+}
+
+// ******** Bench_Run ************
+// Initialize the OS and UART0, run every benchmark and print
+// the results, then repeat
+// Inputs:  none
+// Outputs: none (does not return)
+void Bench_Run(void){
+  OS_Init();
+  UART0_Init();
+  OSPort_CycleInit();
+  OS_InitSemaphore(&StartSwitch, 0);
+  OS_InitSemaphore(&StartPing, 0);
+  OS_InitSemaphore(&StartFifo, 0);
+  OS_InitSemaphore(&Done, 0);
+  OS_InitSemaphore(&Ping, 0);
+  OS_InitSemaphore(&Pong, 0);
+  OS_InitSemaphore(&FifoAck, 0);
+  OS_InitSemaphore(&Dummy, 0);
+  OS_FIFO_Init();
+#if OS_SRP
+  Srp_Init();
+  Srp_Job(&SrpLow, &srplow, 1);   Srp_Uses(&SrpLow, &SrpRes);
+  Srp_Job(&SrpMid, &srpmid, 3);   Srp_Uses(&SrpMid, &SrpRes);
+  Srp_Job(&SrpTop, &srptop, 4);
+#endif
+  OS_AddThreads(&Controller,0, &SwitchThread,1, &SwitchThread,1, &PingThread,1,
+                &PongThread,1, &Producer,1, &Consumer,1, 0,0);
+  OS_Launch(BSP_Clock_GetFreq()/THREADFREQ); // doesn't return
+}
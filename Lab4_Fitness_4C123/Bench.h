@@ -0,0 +1,32 @@
+// Bench.h
+// Runs on TM4C123
+// Kernel microbenchmarks.  Replaces the fitness device threads with
+// benchmark threads that time the kernel in bus cycles using the
+// DWT cycle counter, then print min/median/max of each measurement
+// out UART0 (115200 bps, 8-N-1).
+// October 19, 2026
+
+// Set OS_BENCH to 1 (e.g., OS_BENCH=1 in the Keil C/C++ Define box)
+// to build the benchmark image; main() in Lab4.c then calls Bench_Run.
+// Save the output of a known good kernel and compare later runs
+// against it with Host/benchcmp.py.
+// Built with OS_SRP as well (Srp.h), it also checks SRP ceiling blocking.
+// Note: TExaS also uses UART0, so it is not started in this image.
+
+#ifndef __BENCH_H
+#define __BENCH_H  1
+
+#ifndef OS_BENCH
+#define OS_BENCH 0
+#endif
+
+#define BENCHSAMPLES 501  // samples per measurement, odd so the median is one sample
+
+// ******** Bench_Run ************
+// Initialize the OS and UART0, run every benchmark and print
+// the results, then repeat
+// Inputs:  none
+// Outputs: none (does not return)
+void Bench_Run(void);
+
+#endif
@@ -0,0 +1,144 @@
+// Deadlock.c
+// Runs on TM4C123
+// Deadlock detector for semaphores used as mutexes, see Deadlock.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Deadlock.h"
+#include "CortexM.h"
+#include "UART0.h"
+
+#define NOOWNER (-1)
+struct mutex{
+  int32_t *semaPt;        // 0 for a free entry
+  const char *name;
+  int32_t owner;          // thread holding it, NOOWNER if free
+};
+typedef struct mutex mutexType;
+mutexType Mutexes[DEADLOCKMUTEXES];
+mutexType *Waiting[DEADLOCKTHREADS]; // registered mutex each thread is blocked on, 0 if none
+deadlockType Deadlock;               // the cycle found last
+uint32_t DeadlockNew;                // nonzero if Deadlock has not been printed
+
+static mutexType *lookup(int32_t *semaPt){
+  for(int i=0; i<DEADLOCKMUTEXES; i++){
+    if(Mutexes[i].semaPt == semaPt){
+      return &Mutexes[i];
+    }
+  }
+  return 0;
+}
+
+// ******** Deadlock_Mutex ************
+// Have the detector treat a semaphore as a mutex
+// Inputs:  semaPt, pointer to a semaphore that starts at 1
+//          name, string constant used in the report
+// Outputs: 1 if successful, 0 if DEADLOCKMUTEXES are already registered
+int Deadlock_Mutex(int32_t *semaPt, const char *name){
+  mutexType *pt;
+  int32_t status;
+  status = StartCritical();
+  pt = lookup(semaPt);
+  if(pt == 0){
+    pt = lookup(0);       // free entry
+  }
+  if(pt){
+    pt->semaPt = semaPt;
+    pt->name = name;
+    pt->owner = NOOWNER;
+  }
+  EndCritical(status);
+  return pt != 0;
+}
+
+// ******** Deadlock_Wait ************
+// Record the new owner, or check the wait-for chain before blocking
+// Inputs:  semaPt, pointer to the semaphore
+//          thread, thread number of the caller
+// Outputs: none
+void Deadlock_Wait(int32_t *semaPt, uint32_t thread){
+  mutexType *pt = lookup(semaPt);
+  uint32_t n, t;
+  uint32_t threads[DEADLOCKTHREADS];  // the chain, copied to Deadlock only if it is a cycle
+  int32_t *mutexes[DEADLOCKTHREADS];
+  if(pt == 0){
+    return;               // not a mutex
+  }
+  if(*semaPt >= 0){
+    pt->owner = thread;   // got it
+    return;
+  }
+  Waiting[thread] = pt;
+  t = thread;
+  n = 0;
+  while(n < DEADLOCKTHREADS){
+    threads[n] = t;
+    mutexes[n] = pt->semaPt;
+    n++;
+    if(pt->owner == NOOWNER){
+      return;             // released by a thread that did not own it
+    }
+    t = pt->owner;
+    if(t == thread){       // back to the caller, a cycle
+      for(uint32_t k=0; k<n; k++){
+        Deadlock.thread[k] = threads[k];
+        Deadlock.mutex[k] = mutexes[k];
+      }
+      Deadlock.length = n;
+      DeadlockNew = 1;
+      return;
+    }
+    pt = Waiting[t];
+    if(pt == 0){
+      return;             // the owner is not waiting on a mutex
+    }
+  }
+}
+
+// ******** Deadlock_Signal ************
+// Pass the mutex to the thread the signal unblocked
+// Inputs:  semaPt, pointer to the semaphore
+//          thread, thread number unblocked by this signal, -1 for none
+// Outputs: none
+void Deadlock_Signal(int32_t *semaPt, int32_t thread){
+  mutexType *pt = lookup(semaPt);
+  if(pt == 0){
+    return;
+  }
+  pt->owner = thread;     // NOOWNER if nobody was waiting
+  if(thread != NOOWNER){
+    Waiting[thread] = 0;
+  }
+}
+
+static void outname(int32_t *semaPt){
+  mutexType *pt = lookup(semaPt);
+  if(pt && pt->name){
+    UART0_OutString((char *)pt->name);
+  } else{
+    UART0_OutUHex((uint32_t)(uintptr_t)semaPt);
+  }
+}
+
+// ******** Deadlock_Report ************
+// Print a cycle found by Deadlock_Wait, once, out UART0
+// Inputs:  none
+// Outputs: none
+void Deadlock_Report(void){
+  uint32_t k, n;
+  if(DeadlockNew == 0){
+    return;
+  }
+  DeadlockNew = 0;
+  n = Deadlock.length;
+  UART0_OutString("DEADLOCK\r\n");
+  for(k=0; k<n; k++){
+    UART0_OutString("  thread ");
+    UART0_OutUDec(Deadlock.thread[k]);
+    UART0_OutString(" waits for ");
+    outname(Deadlock.mutex[k]);
+    UART0_OutString(" held by thread ");
+    UART0_OutUDec(Deadlock.thread[(k+1)%n]);
+    UART0_OutString("\r\n");
+  }
+}
@@ -0,0 +1,86 @@
+// Deadlock.h
+// Runs on TM4C123
+// Deadlock detector for semaphores used as mutexes.  The OS records
+// which thread holds each registered mutex and which mutex each
+// thread is blocked on.  Before a thread blocks, the detector follows
+// the chain mutex -> owner -> mutex that owner is blocked on -> ...;
+// if the chain comes back to the thread, the wait can never end,
+// and the cycle is recorded and printed out UART0 by that thread
+// before it blocks for good, with interrupts still disabled.
+// October 19, 2026
+
+// Set OS_DEADLOCK to 1 (e.g., OS_DEADLOCK=1 in the Keil C/C++ Define
+// box) for a debug build with the detector.  With OS_DEADLOCK 0 the
+// DEADLOCK_xxx() macros compile to nothing.
+// A registered mutex must start at 1 and be signaled only by the
+// thread that waited on it.
+// Note: TExaS also uses UART0, so Lab4.c does not start it in this build.
+
+#ifndef __DEADLOCK_H
+#define __DEADLOCK_H  1
+
+#ifndef OS_DEADLOCK
+#define OS_DEADLOCK 0
+#endif
+
+#define DEADLOCKMUTEXES 8   // mutexes that can be registered
+#define DEADLOCKTHREADS 9   // thread numbers 0 to 8, as in the OS
+
+// the cycle found last: thread[k] is blocked on mutex[k], which is
+// held by thread[k+1]; the last one's mutex is held by thread[0]
+struct deadlock{
+  uint32_t length;                      // threads in the cycle, 0 if none found
+  uint32_t thread[DEADLOCKTHREADS];
+  int32_t *mutex[DEADLOCKTHREADS];
+};
+typedef struct deadlock deadlockType;
+extern deadlockType Deadlock;
+
+// ******** Deadlock_Mutex ************
+// Have the detector treat a semaphore as a mutex, call after
+// OS_InitSemaphore and before any thread uses it
+// Inputs:  semaPt, pointer to a semaphore that starts at 1
+//          name, string constant used in the report
+// Outputs: 1 if successful, 0 if DEADLOCKMUTEXES are already registered
+int Deadlock_Mutex(int32_t *semaPt, const char *name);
+
+// ******** Deadlock_Wait ************
+// Called by OS_Wait with interrupts disabled, after it decrements
+// the semaphore.  The thread either holds the mutex now or is about
+// to block on it; in that case the wait-for chain is checked
+// Inputs:  semaPt, pointer to the semaphore
+//          thread, thread number of the caller
+// Outputs: none
+void Deadlock_Wait(int32_t *semaPt, uint32_t thread);
+
+// ******** Deadlock_Signal ************
+// Called by OS_Signal with interrupts disabled, after it increments
+// the semaphore.  The mutex passes to the thread it unblocked, if any
+// Inputs:  semaPt, pointer to the semaphore
+//          thread, thread number unblocked by this signal, -1 for none
+// Outputs: none
+void Deadlock_Signal(int32_t *semaPt, int32_t thread);
+
+// ******** Deadlock_Report ************
+// Print a cycle found by Deadlock_Wait, once, out UART0
+// Called by OS_Wait right after Deadlock_Wait, with interrupts still
+// disabled: once the caller is marked blocked it never runs again.
+// The printout holds off interrupts for a few ms, once
+// UART0_Init must have been called
+// Inputs:  none
+// Outputs: none
+void Deadlock_Report(void);
+
+#if OS_DEADLOCK
+#define DEADLOCK_MUTEX(semaPt,name) Deadlock_Mutex((semaPt),(name))
+#define DEADLOCK_WAIT(semaPt,thread) Deadlock_Wait((semaPt),(thread))
+#define DEADLOCK_SIGNAL(semaPt,thread) Deadlock_Signal((semaPt),(thread))
+#define DEADLOCK_REPORT() Deadlock_Report()
+#else
+#define DEADLOCK_MUTEX(semaPt,name)
+#define DEADLOCK_WAIT(semaPt,thread)
+#define DEADLOCK_SIGNAL(semaPt,thread)
+#define DEADLOCK_REPORT()
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+// I2CQ.c
+// Runs on TM4C123
+// Interrupt-driven I2C1 master with a transaction queue, see I2CQ.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "I2CQ.h"
+#include "os.h"
+#include "CortexM.h"
+#include "../inc/tm4c123gh6pm.h"
+
+// I2C1_MCS_R commands
+#define MCS_RUN    0x01
+#define MCS_START  0x02
+#define MCS_STOP   0x04
+#define MCS_ACK    0x08
+// I2C1_MCS_R status
+#define MCS_BUSY   0x01
+#define MCS_ERROR  0x02
+#define MCS_ARBLST 0x10
+
+i2cReqType *I2CHead;      // transaction on the bus, 0 if idle
+i2cReqType *I2CTail;      // last queued
+uint32_t I2CErrors;       // transactions that ended in I2CQ_ERROR
+
+// start the first byte of the transaction at the head of the queue
+static void start(void){
+  i2cReqType *req = I2CHead;
+  uint32_t stop;
+  req->count = 0;
+  if(req->wlen){
+    stop = (req->wlen == 1)&&(req->rlen == 0);
+    I2C1_MSA_R = req->addr<<1;            // write
+    I2C1_MDR_R = req->tx[0];
+    I2C1_MCS_R = MCS_START|MCS_RUN|(stop ? MCS_STOP : 0);
+  } else{
+    I2C1_MSA_R = (req->addr<<1)|1;        // read
+    I2C1_MCS_R = MCS_START|MCS_RUN|((req->rlen > 1) ? MCS_ACK : MCS_STOP);
+  }
+}
+
+// the head transaction has ended, report it and start the next
+static void finish(uint32_t status){
+  i2cReqType *req = I2CHead;
+  I2CHead = req->next;
+  if(I2CHead == 0){
+    I2CTail = 0;
+  }
+  req->status = status;
+  if(req->semaPt){
+    OS_Signal(req->semaPt);
+  }
+  if(req->done){
+    req->done(req);
+  }
+  if(I2CHead){
+    start();                             // pipelined, no gap for a thread to run
+  }
+}
+
+// ******** I2CQ_Init ************
+// Initialize I2C1 at 400 kHz with master interrupts, priority 3
+// Inputs:  none
+// Outputs: none
+void I2CQ_Init(void){
+  SYSCTL_RCGCI2C_R |= 0x02;             // activate I2C1
+  SYSCTL_RCGCGPIO_R |= 0x01;            // activate port A
+  while((SYSCTL_PRGPIO_R&0x01) == 0){};
+  GPIO_PORTA_AFSEL_R |= 0xC0;           // alt funct on PA7-6
+  GPIO_PORTA_ODR_R |= 0x80;             // open drain on PA7 (SDA)
+  GPIO_PORTA_DEN_R |= 0xC0;             // digital I/O on PA7-6
+  GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R&0x00FFFFFF)|0x33000000; // I2C1
+  GPIO_PORTA_AMSEL_R &= ~0xC0;          // no analog on PA7-6
+  while((SYSCTL_PRI2C_R&0x02) == 0){};
+  I2C1_MCR_R = 0x00000010;              // master function
+  I2C1_MTPR_R = 9;                      // 400 kHz: 80 MHz/(20*(9+1))
+  I2C1_MICR_R = 0x01;                   // clear master interrupt
+  I2C1_MIMR_R = 0x01;                   // arm master interrupt
+  NVIC_PRI9_R = (NVIC_PRI9_R&0xFFFF00FF)|0x00006000; // priority 3, IRQ 37
+  NVIC_EN1_R = 1<<(37-32);              // enable IRQ 37 in NVIC
+  I2CHead = I2CTail = 0;
+}
+
+// ******** I2CQ_Submit ************
+// Queue a transaction, never blocks
+// Inputs:  req, transaction
+// Outputs: none
+void I2CQ_Submit(i2cReqType *req){
+  int32_t status;
+  req->next = 0;
+  req->status = I2CQ_PENDING;
+  status = StartCritical();
+  if(I2CTail){
+    I2CTail->next = req;
+    I2CTail = req;
+  } else{
+    I2CHead = I2CTail = req;            // bus idle, start now
+    start();
+  }
+  EndCritical(status);
+}
+
+// ******** I2CQ_Transfer ************
+// Queue a transaction and wait for it, in a main thread
+// Inputs:  req, transaction
+// Outputs: I2CQ_OK or I2CQ_ERROR
+uint32_t I2CQ_Transfer(i2cReqType *req){
+  I2CQ_Submit(req);
+  OS_Wait(req->semaPt);
+  return req->status;
+}
+
+// one byte of the head transaction has moved
+void I2C1_Handler(void){
+  i2cReqType *req = I2CHead;
+  uint32_t mcs, last;
+  I2C1_MICR_R = 0x01;                   // acknowledge
+  if(req == 0){
+    return;                             // no transaction, spurious
+  }
+  mcs = I2C1_MCS_R;
+  if(mcs&(MCS_ERROR|MCS_ARBLST)){
+    if((mcs&MCS_ARBLST) == 0){
+      I2C1_MCS_R = MCS_STOP;            // release the bus
+      while(I2C1_MCS_R&MCS_BUSY){};     // one bit time at 400 kHz
+    }
+    I2CErrors++;
+    finish(I2CQ_ERROR);
+    return;
+  }
+  if(req->count < req->wlen){           // a write byte went out
+    req->count++;
+    if(req->count < req->wlen){
+      last = (req->count == req->wlen-1)&&(req->rlen == 0);
+      I2C1_MDR_R = req->tx[req->count];
+      I2C1_MCS_R = MCS_RUN|(last ? MCS_STOP : 0);
+    } else if(req->rlen){               // repeated start for the reads
+      I2C1_MSA_R = (req->addr<<1)|1;
+      I2C1_MCS_R = MCS_START|MCS_RUN|((req->rlen > 1) ? MCS_ACK : MCS_STOP);
+    } else{
+      finish(I2CQ_OK);
+    }
+    return;
+  }
+  req->rx[req->count - req->wlen] = I2C1_MDR_R; // a read byte came in
+  req->count++;
+  if(req->count < req->wlen + req->rlen){
+    last = (req->count == req->wlen + req->rlen - 1);
+    I2C1_MCS_R = MCS_RUN|(last ? MCS_STOP : MCS_ACK);
+  } else{
+    finish(I2CQ_OK);
+  }
+}
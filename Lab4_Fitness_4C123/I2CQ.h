@@ -0,0 +1,56 @@
+// I2CQ.h
+// Runs on TM4C123
+// Interrupt-driven I2C1 master with a transaction queue, for the
+// BoosterPack TMP006 and OPT3001 sensors (SCL PA6 J1.9, SDA PA7 J1.10).
+// A transaction writes 0 to 4 bytes, then reads 0 to 4 bytes after
+// a repeated start.  Threads queue transactions and block until they
+// are done; the I2C1 interrupt moves each byte and starts the next
+// queued transaction as soon as one ends, so no thread polls the bus
+// and back-to-back transactions run without a gap.
+// October 19, 2026
+
+#ifndef __I2CQ_H
+#define __I2CQ_H  1
+
+#define I2CQ_PENDING 0    // queued or on the bus
+#define I2CQ_OK      1    // finished
+#define I2CQ_ERROR   2    // no acknowledge or arbitration lost
+
+struct i2creq{
+  struct i2creq *next;     // queue, set by I2CQ_Submit
+  uint8_t addr;            // 7-bit slave address
+  uint8_t wlen;            // bytes of tx to write, 0 to 4
+  uint8_t rlen;            // bytes to read into rx, 0 to 4
+  uint8_t count;           // bytes moved so far, used by the driver
+  uint8_t tx[4];
+  uint8_t rx[4];
+  int32_t *semaPt;         // signaled when done, 0 for none
+  void (*done)(struct i2creq *req); // called in the interrupt when done, 0 for none
+  volatile uint32_t status;// I2CQ_PENDING, I2CQ_OK or I2CQ_ERROR
+};
+typedef struct i2creq i2cReqType;
+
+// ******** I2CQ_Init ************
+// Initialize I2C1 at 400 kHz with master interrupts, priority 3
+// Call before OS_Launch; transactions submitted before OS_Launch
+// run once interrupts are enabled
+// Inputs:  none
+// Outputs: none
+void I2CQ_Init(void);
+
+// ******** I2CQ_Submit ************
+// Queue a transaction, never blocks.  req must not be changed until
+// its status is no longer I2CQ_PENDING
+// Callable from main threads and interrupts
+// Inputs:  req, transaction with addr, wlen, tx, rlen, semaPt and done set
+// Outputs: none
+void I2CQ_Submit(i2cReqType *req);
+
+// ******** I2CQ_Transfer ************
+// Queue a transaction and wait for it, in a main thread
+// req->semaPt must point to a semaphore that starts at 0
+// Inputs:  req, transaction
+// Outputs: I2CQ_OK or I2CQ_ERROR
+uint32_t I2CQ_Transfer(i2cReqType *req);
+
+#endif
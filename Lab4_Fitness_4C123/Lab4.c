@@ -39,9 +39,21 @@
 #include "Profile.h"
 #include "Texas.h"
 #include "CortexM.h"
+#include "UART0.h"
 #include "os.h"
+#include "osport.h"
+#include "TaskTable.h"
+#include "Trace.h"
+#include "SemStats.h"
+#include "Deadlock.h"
+#include "Bench.h"
+#include "FlashProgram.h"
+#include "Proto.h"
+#include "I2CQ.h"
+#include "MicDMA.h"
+#include "Audio.h"
+#include "StepDetect.h"
 
-uint32_t sqrt32(uint32_t s);
 #define THREADFREQ 1000   // frequency in Hz of round robin scheduler
 
 //---------------- Global variables shared between tasks ----------------
@@ -51,15 +63,13 @@ uint32_t Magnitude;         // will not overflow (3*1,023^2 = 3,139,587)
                             // Exponentially Weighted Moving Average
 uint32_t EWMA;              // https://en.wikipedia.org/wiki/Moving_average#Exponential_moving_average
 uint16_t SoundData;         // raw data sampled from the microphone
-int32_t SoundAvg;
-
+int32_t SoundAvg;           // DC level of the microphone
+uint32_t SoundPeak;         // held peak of the DC-free sound
 uint32_t SoundRMS;          // Root Mean Square average of most recent sound samples
 uint32_t LightData;         // 100 lux
-int32_t TemperatureData;    // 0.1C
-// semaphores
-int32_t NewData;  // true when new numbers to display on top of LCD
-int32_t LCDmutex; // exclusive access to LCD
-int32_t I2Cmutex; // exclusive access to I2C
+int32_t TemperatureData;    // 0.1C, object temperature from the TMP006 thermopile
+// semaphores, see TaskTable.h
+FITNESS_SEMAPHORES(OS_SEMAPHORE_DEFINE)
 int ReDrawAxes = 0;         // non-zero means redraw axes on next display task
 
 enum plotstate{
@@ -82,37 +92,52 @@ enum plotstate PlotState = Accelerometer;
 //------------ end of Global variables shared between tasks -------------
 
 //---------------- Task0 samples sound from microphone ----------------
-// High priority thread run by OS in real time at 1000 Hz
-#define SOUNDRMSLENGTH 1000 // number of samples to collect before calculating RMS (may overflow if greater than 4104)
-int16_t SoundArray[SOUNDRMSLENGTH];
-int32_t TakeSoundData; // binary semaphore
-int32_t ADCmutex;      // access to ADC
+// High priority thread run by OS once per block of MICBLOCK samples
+#define SOUNDRATE 8000      // microphone samples per second, 2000 to 16000, Timer1A triggers ADC1
+#define MICBLOCK 128        // samples per uDMA block, Task0 runs every 16 ms at 8 kHz
+#define SOUNDWINDOW ((SOUNDRATE/MICBLOCK)*MICBLOCK) // samples per RMS result, whole blocks, 0.992 sec at 8 kHz
+#define PEAKHOLD 3          // RMS results the peak is held for
+audioType Sound;            // DC removal, RMS and peak hold, see Audio.h
+uint32_t SoundLoad;         // CPU used by Task0 block processing, in 0.01%
+uint32_t SoundCyclesMax;    // longest block processing time, bus cycles
 // *********Task0*********
 // Task0 measures sound intensity
-// Periodic main thread runs in real time at 1000 Hz
-// collects data from microphone, high priority
+// Main thread runs in real time once per MICBLOCK samples
+// collects blocks from the microphone, high priority
 // Inputs:  none
 // Outputs: none
 void Task0(void){
-  static int32_t soundSum = 0;
-  static int time = 0;// units of microphone sampling rate
+  uint32_t cyclesSum = 0;   // block processing this window
+  uint32_t blocks = 0;      // blocks this window
+  uint32_t start, cycles;
+  uint16_t *block;
 
   SoundRMS = 0;
+  Audio_Init(&Sound, SOUNDWINDOW, PEAKHOLD);
   while(1){
-    OS_Wait(&TakeSoundData); // signaled by OS every 1ms
+    OS_Wait(&SoundBlock); // signaled by the ADC1 interrupt every MICBLOCK samples
+    OS_Heartbeat();
     TExaS_Task0();     // record system time in array, toggle virtual logic analyzer
     Profile_Toggle0(); // viewed by the logic analyzer to know Task0 started
-    OS_Wait(&ADCmutex);
-    BSP_Microphone_Input(&SoundData);
-    OS_Signal(&ADCmutex);
-    soundSum = soundSum + (int32_t)SoundData;
-    SoundArray[time] = SoundData;
-    time = time + 1;
-    if(time == SOUNDRMSLENGTH){
-      SoundAvg = soundSum/SOUNDRMSLENGTH;
-      soundSum = 0;
+    start = OSPort_Cycles();
+    block = MicDMA_Get();
+    SoundData = block[MICBLOCK-1];  // newest sample, for the plot
+    if(Audio_Block(&Sound, block, MICBLOCK)){
+      SoundRMS = Sound.rms;
+      SoundPeak = Sound.peakHold;
+      SoundAvg = Sound.mean;
       OS_Signal(&NewData); // makes task5 run every 1 sec
-      time = 0;
+    }
+    cycles = OSPort_Cycles() - start;
+    if(cycles > SoundCyclesMax){
+      SoundCyclesMax = cycles;
+    }
+    cyclesSum = cyclesSum + cycles;
+    blocks = blocks + 1;
+    if(Sound.count == 0){  // window ended, load over its blocks
+      SoundLoad = cyclesSum/(blocks*MICBLOCK*(BSP_Clock_GetFreq()/SOUNDRATE)/10000);
+      cyclesSum = 0;
+      blocks = 0;
     }
   }
 }
@@ -122,21 +147,15 @@ void Task0(void){
 
 //---------------- Task1 measures acceleration ----------------
 // Event thread run by OS in real time at 10 Hz
-int32_t TakeAccelerationData;
 uint32_t LostTask1Data;     // number of times that the FIFO was full when acceleration data was ready
 uint16_t AccX, AccY, AccZ;  // returned by BSP as 10-bit numbers
-#define ALPHA 128           // The degree of weighting decrease, a constant smoothing factor between 0 and 1,023. A higher ALPHA discounts older observations faster.
-                            // basic step counting algorithm is based on a forum post from
-                            // http://stackoverflow.com/questions/16392142/android-accelerometer-profiling/16539643#16539643
-enum state{                 // the step counting algorithm cycles through four states
-  LookingForMax,            // looking for a local maximum in current magnitude
-  LookingForCross1,         // looking for current magnitude to cross average magnitude, minus a constant
-  LookingForMin,            // looking for a local minimum in current magnitude
-  LookingForCross2          // looking for current magnitude to cross average magnitude, plus a constant
-};
-enum state AlgorithmState = LookingForMax;
-#define LOCALCOUNTTARGET 5  // The number of valid measured magnitudes needed to confirm a local min or local max.  Increase this number for longer strides or more frequent measurements.
-#define AVGOVERSHOOT 25     // The amount above or below average a measurement must be to count as "crossing" the average.  Increase this number to reject increasingly hard shaking as steps.
+#define STEPSQUARED 0       // 1 to count steps on squared magnitudes, no sqrt32 per sample
+#if STEPSQUARED
+#define STEPMODE STEP_SQUARED
+#else
+#define STEPMODE STEP_MAGNITUDE
+#endif
+stepDetectType StepDetector; // step counter, see StepDetect.h for the algorithm and its parameters
 // *********Task1*********
 // Task1 collects data from accelerometer in real time
 // Periodic main thread runs in real time at 10 Hz
@@ -145,17 +164,18 @@ enum state AlgorithmState = LookingForMax;
 void Task1(void){uint32_t squared;
   // initialize the exponential weighted moving average filter
   BSP_Accelerometer_Input(&AccX, &AccY, &AccZ);
-  Magnitude = sqrt32(AccX*AccX + AccY*AccY + AccZ*AccZ);
-  EWMA = Magnitude;                // this is a guess; there are many options
+  squared = AccX*AccX + AccY*AccY + AccZ*AccZ;
+  StepDetect_Init(&StepDetector, STEPMODE, squared);
+  Magnitude = StepDetect_Magnitude(&StepDetector);
+  EWMA = StepDetect_Average(&StepDetector);
   Steps = 0;
   LostTask1Data = 0;
   while(1){
     OS_Wait(&TakeAccelerationData); // signaled by OS every 100ms
+    OS_Heartbeat();
     TExaS_Task1();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle1(); // viewed by the logic analyzer to know Task1 started
-    OS_Wait(&ADCmutex);
-    BSP_Accelerometer_Input(&AccX, &AccY, &AccZ);
-    OS_Signal(&ADCmutex);
+    BSP_Accelerometer_Input(&AccX, &AccY, &AccZ); // ADC0 is Task1's alone
     squared = AccX*AccX + AccY*AccY + AccZ*AccZ;
     if(OS_FIFO_Put(squared) == -1){  // makes Task2 run every 100ms
       LostTask1Data = LostTask1Data + 1;
@@ -194,65 +214,17 @@ void drawaxes(void){
   OS_Signal(&LCDmutex);  ReDrawAxes = 0;
 }
 void Task2(void){uint32_t data;
-  uint32_t localMin;   // smallest measured magnitude since odd-numbered step detected
-  uint32_t localMax;   // largest measured magnitude since even-numbered step detected
-  uint32_t localCount; // number of measured magnitudes above local min or below local max
-  localMin = 1024;
-  localMax = 0;
-  localCount = 0;
   drawaxes();
   while(1){
     data = OS_FIFO_Get();
+    OS_Heartbeat();
     TExaS_Task2();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle2(); // viewed by the logic analyzer to know Task2 started
-    Magnitude = sqrt32(data);
-    EWMA = (ALPHA*Magnitude + (1023 - ALPHA)*EWMA)/1024;
-    if(AlgorithmState == LookingForMax){
-      if(Magnitude > localMax){
-        localMax = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross1;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross1){
-      if(Magnitude > localMax){
-      // somehow measured a very large magnitude
-        localMax = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      } else if(Magnitude < (EWMA -  AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMin = 1024;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      }
-    } else if(AlgorithmState == LookingForMin){
-      if(Magnitude < localMin){
-        localMin = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross2;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross2){
-      if(Magnitude < localMin){
-      // somehow measured a very small magnitude
-        localMin = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      } else if(Magnitude > (EWMA + AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMax = 0;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      }
+    StepDetect_Put(&StepDetector, data);
+    Steps = StepDetector.steps;
+    if(PlotState == Accelerometer){  // sqrt32 only for the plot if STEPSQUARED
+      Magnitude = StepDetect_Magnitude(&StepDetector);
+      EWMA = StepDetect_Average(&StepDetector);
     }
     if(ReDrawAxes){
       drawaxes();
@@ -280,40 +252,34 @@ void Task2(void){uint32_t data;
 
 //------------Task3 handles switch input, buzzer output-------
 // *********Task3*********
-// Main thread scheduled by OS round robin preemptive scheduler
+// Protothread run by Proto_Run (Proto.h), which has the thread slot
 // real-time task, signaled on touch
-//   with bouncing, may also be called on release
-// checks the switches, updates the mode, and outputs to the buzzer and LED
-// Inputs:  none
-// Outputs: none
-int32_t SwitchTouch;
-void Task3(void){
-  uint8_t current;
-	OS_InitSemaphore(&SwitchTouch,0); // signaled on touch button1
-	OS_EdgeTrigger_Init(&SwitchTouch, 3);
+//   the OS debounces Button1 and signals only if it is still pressed
+// updates the mode, and outputs to the buzzer and LED
+// Inputs:  pt, Task3Proto
+// Outputs: PROTO_WAITING (never ends)
+protoType Task3Proto;
+int Task3(protoType *pt){
+  PROTO_BEGIN(pt);
   while(1){
-		OS_Wait(&SwitchTouch); // OS signals on touch
+    PROTO_WAIT(pt, &SwitchTouch); // OS signals on touch
     TExaS_Task3();         // records system time in array, toggles virtual logic analyzer
     Profile_Toggle3();     // viewed by the logic analyzer to know Task3 started
-    OS_Sleep(10);          // debounce the switches
-    current = BSP_Button1_Input();
-    if(current == 0){     // Button1 was pressed 
-      BSP_Buzzer_Set(512);   // beep for 20ms
-      OS_Sleep(20);          
-      BSP_Buzzer_Set(0);
-      if(PlotState == Accelerometer){
-        PlotState = Microphone;
-      } else if(PlotState == Microphone){
-        PlotState = Temperature;
-      } else if(PlotState == Temperature){
-        PlotState = Light;
-      } else if(PlotState == Light){
-        PlotState = Accelerometer;
-      }
-      ReDrawAxes = 1;      // redraw axes on next call of display task
+    BSP_Buzzer_Set(512);   // beep for 20ms
+    PROTO_SLEEP(pt, 20);
+    BSP_Buzzer_Set(0);
+    if(PlotState == Accelerometer){
+      PlotState = Microphone;
+    } else if(PlotState == Microphone){
+      PlotState = Temperature;
+    } else if(PlotState == Temperature){
+      PlotState = Light;
+    } else if(PlotState == Light){
+      PlotState = Accelerometer;
     }
-		OS_EdgeTrigger_Restart();
+    ReDrawAxes = 1;        // redraw axes on next call of display task
   }
+  PROTO_END(pt);
 }
 /* ****************************************** */
 /*          End of Task3 Section              */
@@ -323,26 +289,61 @@ void Task3(void){
 //------------Task4 measures temperature-------
 // *********Task4*********
 // Main thread scheduled by OS round robin preemptive scheduler
-// measures temperature
+// measures temperature, reads are released exactly every 1 sec
 // Inputs:  none
 // Outputs: none
-void Task4(void){int32_t voltData,tempData;
-  int done;
+// The TMP006 converts continuously, a new average every 1 sec
+uint32_t TempOverruns;  // number of 1 sec releases Task4 missed
+i2cReqType TempSetup = {0, 0x40, 3, 0, 0, {0x02, 0x74, 0x00}}; // continuous, 4 samples averaged
+i2cReqType TempRead = {0, 0x40, 1, 2, 0, {0x01}, {0}, &TempDone}; // die temperature
+i2cReqType VobjRead = {0, 0x40, 1, 2, 0, {0x00}, {0}, &TempDone}; // thermopile voltage
+
+// TMP006 object temperature, TI SBOU107 with its typical constants,
+// as BSP_TempSensor_End computed it, in 64-bit integers so no thread
+// uses the FPU (SysTick_Handler does not save its registers)
+//   Tobj^4 = Tdie^4 + f(Vobj)/S, S = S0(1 + a1 dT + a2 dT^2),
+//   f(V) = (V - Vos) + c2 (V - Vos)^2, Vos = b0 + b1 dT + b2 dT^2
+// within 0.1 C of the floating-point formula from -40 to 150 C
+// Inputs:  vobj, register 0x00, 156.25 nV units
+//          die, register 0x01 shifted right 2, 1/32 C units
+// Outputs: object temperature in 0.1 C
+static int32_t tmp006object(int32_t vobj, int32_t die){
+  int64_t dt = die - 800;                  // Tdie - 298.15 K in 1/32 K
+  int64_t tk = die + 8741;                 // Tdie in 1/32 K
+  int64_t s = 1048576 + (1835*dt)/32 - (17595*dt*dt)/1024000; // S/S0 in 2^-20 units
+  int64_t x = (int64_t)vobj*625/4 + 29400 + (570*dt)/32 - (463*dt*dt)/102400; // Vobj - Vos in nV
+  int64_t f = x + (134*x*x)/10000000000LL; // f(Vobj) in nV
+  int64_t t4 = (tk*tk*tk*tk)/1048576 + (f*1048576*15625)/s; // Tobj^4 in K^4, 1/S0 = 15625/nV
+  uint64_t lo = 0, hi = 65535, mid;        // Tobj in 0.01 K, by bisection
+  if(t4 < 0){
+    t4 = 0;
+  }
+  if(t4 > 180000000000LL){
+    t4 = 180000000000LL;                   // 651 K, keeps t4*10^8 in 64 bits
+  }
+  t4 = t4*100000000;
+  while(lo < hi){
+    mid = (lo + hi + 1)/2;
+    if(mid*mid*mid*mid <= (uint64_t)t4){
+      lo = mid;
+    } else{
+      hi = mid - 1;
+    }
+  }
+  return ((int32_t)lo - 27315 + 100005)/10 - 10000; // 0.1 C, rounded
+}
+
+void Task4(void){ int32_t die;
+  uint32_t lastWake = OS_MsTime();
   while(1){
+    OS_Heartbeat();
     TExaS_Task4();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle4(); // viewed by the logic analyzer to know Task4 started
-
-    OS_Wait(&I2Cmutex);
-    BSP_TempSensor_Start();
-    OS_Signal(&I2Cmutex);
-    done = 0;
-    OS_Sleep(1000);    // waits about 1 sec
-    while(done == 0){
-      OS_Wait(&I2Cmutex);
-      done = BSP_TempSensor_End(&voltData, &tempData);
-      OS_Signal(&I2Cmutex);
+    TempOverruns += OS_SleepUntil(&lastWake, 1000); // 1 sec after the last release
+    if((I2CQ_Transfer(&TempRead) == I2CQ_OK)&&(I2CQ_Transfer(&VobjRead) == I2CQ_OK)){
+      die = (int16_t)((TempRead.rx[0]<<8)|TempRead.rx[1])>>2; // 1/32 C in bits 15-2
+      TemperatureData = tmp006object((int16_t)((VobjRead.rx[0]<<8)|VobjRead.rx[1]), die);
     }
-    TemperatureData = tempData/10000;
   }
 }
 /* ****************************************** */
@@ -360,7 +361,7 @@ void Task4(void){int32_t voltData,tempData;
 // updates the text at the top and bottom of the LCD
 // Inputs:  none
 // Outputs: none
-void Task5(void){int32_t soundSum;
+void Task5(void){
   OS_Wait(&LCDmutex);
   BSP_LCD_DrawString(0,  0, "Temp=",  TOPTXTCOLOR);
   BSP_LCD_DrawString(0,  1, "Step=",  TOPTXTCOLOR);
@@ -369,13 +370,9 @@ void Task5(void){int32_t soundSum;
   OS_Signal(&LCDmutex);
   while(1){
     OS_Wait(&NewData);
+    OS_Heartbeat();
     TExaS_Task5();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle5(); // viewed by the logic analyzer to know Task5 started
-    soundSum = 0;
-    for(int i=0; i<SOUNDRMSLENGTH; i=i+1){
-      soundSum = soundSum + (SoundArray[i] - SoundAvg)*(SoundArray[i] - SoundAvg);
-    }
-    SoundRMS = sqrt32(soundSum/SOUNDRMSLENGTH);
     OS_Wait(&LCDmutex);
     BSP_LCD_SetCursor(5,  0); BSP_LCD_OutUFix2_1(TemperatureData, TEMPCOLOR);
     BSP_LCD_SetCursor(5,  1); BSP_LCD_OutUDec4(Steps,             MAGCOLOR);
@@ -386,6 +383,9 @@ void Task5(void){int32_t soundSum;
     if(LostTask1Data){
       BSP_LCD_SetCursor(0, 12); BSP_LCD_OutUDec4(LostTask1Data, BSP_LCD_Color565(255, 0, 0));
     }
+    if(MicDMA_Lost){
+      BSP_LCD_SetCursor(5, 12); BSP_LCD_OutUDec4(MicDMA_Lost, BSP_LCD_Color565(255, 0, 0));
+    }
 //end of debug code
     OS_Signal(&LCDmutex);
   }
@@ -397,50 +397,82 @@ void Task5(void){int32_t soundSum;
 //---------------- Task6 measures light ----------------
 // *********Task6*********
 // Main thread scheduled by OS round robin preemptive scheduler
-// Task6 measures light intensity
+// Task6 measures light intensity, reads are released exactly every 0.8 sec
 // Inputs:  none
 // Outputs: none
-void Task6(void){ uint32_t lightData;
-  int done;
+// The OPT3001 converts continuously, a new result every 0.8 sec
+uint32_t LightOverruns; // number of 0.8 sec releases Task6 missed
+i2cReqType LightSetup = {0, 0x44, 3, 0, 0, {0x01, 0xCC, 0x10}}; // auto range, 800 ms, continuous
+i2cReqType LightRead = {0, 0x44, 1, 2, 0, {0x00}, {0}, &LightDone}; // result
+void Task6(void){ uint32_t raw;
+  uint32_t lastWake = OS_MsTime();
   while(1){
+    OS_Heartbeat();
     TExaS_Task6();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle6(); // viewed by the logic analyzer to know Task6 started
-
-    OS_Wait(&I2Cmutex);
-    BSP_LightSensor_Start();
-    OS_Signal(&I2Cmutex);
-    done = 0;
-    OS_Sleep(800);     // waits about 0.8 sec
-    while(done == 0){
-      OS_Wait(&I2Cmutex);
-      done = BSP_LightSensor_End(&lightData);
-      OS_Signal(&I2Cmutex);
+    LightOverruns += OS_SleepUntil(&lastWake, 800); // 0.8 sec after the last release
+    if(I2CQ_Transfer(&LightRead) == I2CQ_OK){
+      raw = (LightRead.rx[0]<<8)|LightRead.rx[1];
+      LightData = ((raw&0x0FFF)<<(raw>>12))/100; // 0.01 lux times 2^exponent
     }
-    LightData = lightData/100;
   }
 }
 /* ****************************************** */
 /*          End of Task6 Section              */
 /* ****************************************** */
 
-//---------------- Task7 dummy function ----------------
+//---------------- Task7 background function ----------------
 // *********Task7*********
 // Main thread scheduled by OS round robin preemptive scheduler
-// Task7 does nothing but never blocks or sleeps
+// Task7 records the CPU load every 10 ms; when nothing is ready
+// the kernel idle thread sleeps the processor
+// With OS_TRACE it streams the kernel trace out UART0, and with
+// OS_SEMSTATS it prints the semaphore statistics every 5 sec
 // Inputs:  none
 // Outputs: none
 uint32_t Count7;
+uint32_t CPULoad;   // 0.1% units, busy time over the last second
+uint32_t ReleasePeak; // most periodic triggers released in one ms
 void Task7(void){
   Count7 = 0;
   while(1){
+    OS_Heartbeat();
     Count7++;
-    WaitForInterrupt();
+    CPULoad = OS_CPULoad();
+    ReleasePeak = OS_PeriodTrigger_Peak();
+#if OS_TRACE
+    Trace_Flush();
+#endif
+#if OS_SEMSTATS
+    if((Count7%500) == 0){
+      SemStats_Print();
+    }
+#endif
+    OS_Sleep(10);
   }
 }
 /* ****************************************** */
 /*          End of Task7 Section              */
 /* ****************************************** */
 
+//---------------- Watchdog record ----------------
+// The heartbeat of each task is in TaskTable.h.  If one misses,
+// the kernel calls SaveDiag and the watchdog resets the processor;
+// after the reset the record is at DIAGADDR (the debugger memory
+// window, or LastDiag->magic == OSDIAG_MAGIC in code)
+#define DIAGADDR 0x0003FC00  // last 1 KB block of the 256 KB flash
+#define WATCHDOGTIME 100     // msec, longer than the flash erase and write
+#define DEBOUNCETIME 10      // msec Button1 is ignored after a touch
+const osDiagType *LastDiag = (const osDiagType *)DIAGADDR;
+// *********SaveDiag*********
+// Called by the kernel from the 1 ms interrupt just before the reset
+// Inputs:  record, the thread that missed its heartbeat
+// Outputs: none
+void SaveDiag(osDiagType *record){
+  Flash_Erase(DIAGADDR);
+  Flash_WriteArray((uint32_t *)record, DIAGADDR, sizeof(osDiagType)/4);
+}
+
 //---------------- Step 6 ----------------
 // Step 6 is to implement the fitness device by combining the
 // OS functions that were implemented and tested in the earlier
@@ -448,18 +480,22 @@ void Task7(void){
 // step will give you your grade, so remember to change the
 // second parameter in TExaS_Init() to your 4-digit number.
 // Task   Purpose        When to Run
-// Task0  microphone     periodically exactly every 1 ms
+// Task0  microphone     every block of 128 samples taken at 8 kHz
 // Task1  accelerometer  periodically exactly every 100 ms
 // Task2  plot on LCD    after Task1 finishes
 // Task3  switch/buzzer  whenever button 1 touched
 // Task4  temperature    periodically every 1 sec
-// Task5  numbers on LCD after Task0 runs SOUNDRMSLENGTH times
+// Task5  numbers on LCD every SOUNDWINDOW sound samples
 // Task6  light          periodically every 800 ms
-// Task7  dummy          no timing requirement
+// Task7  background     every 10 ms, no timing requirement
 // Remember that you must have exactly one main() function, so
 // to work on this step, you must rename all other main()
 // functions in this file.
+OS_TASKTABLE(FitnessTable, FITNESS_TASKS) // stacks and frames of Task0-Task7
 int main(void){
+#if OS_BENCH
+  Bench_Run();     // kernel benchmark image instead of the fitness device
+#endif
   OS_Init();
   Profile_Init();  // initialize the 7 hardware profiling pins
   BSP_Button1_Init();
@@ -468,25 +504,32 @@ int main(void){
   BSP_Buzzer_Init(0);
   BSP_LCD_Init();
   BSP_LCD_FillScreen(BSP_LCD_Color565(0, 0, 0));
-  BSP_LightSensor_Init();
-  BSP_TempSensor_Init();
+  I2CQ_Init();                    // TMP006 and OPT3001, set up once interrupts are enabled
+  I2CQ_Submit(&TempSetup);
+  I2CQ_Submit(&LightSetup);
   Time = 0;
-  OS_InitSemaphore(&NewData, 0);  // 0 means no data
-  OS_InitSemaphore(&LCDmutex, 1); // 1 means free
-  OS_InitSemaphore(&I2Cmutex, 1); // 1 means free
-  OS_InitSemaphore(&TakeSoundData,0);
-  OS_InitSemaphore(&ADCmutex,1);
-  BSP_Microphone_Init();
+  OSPort_CycleInit();             // Task0 times its block processing
+  MicDMA_Init(SOUNDRATE, MICBLOCK, &SoundBlock); // Timer1A, ADC1 and uDMA
   BSP_Accelerometer_Init();
-  OS_InitSemaphore(&TakeAccelerationData,0);
   OS_FIFO_Init();                 // initialize FIFO used to send data between Task1 and Task2
-  OS_AddThreads(&Task0,0, &Task1,1, &Task2,2, &Task3,3, 
-	              &Task4,3, &Task5,3, &Task6,3, &Task7,4);
-	OS_PeriodTrigger0_Init(&TakeSoundData,1);  // every 1 ms
-	OS_PeriodTrigger1_Init(&TakeAccelerationData,100); //every 100ms
+  OS_AddTaskTable(FitnessTable, OS_TASKCOUNT(FitnessTable)); // semaphores start at their TaskTable.h values
+  Proto_Add(&Task3Proto, &Task3); // runs in the Proto_Run thread
+  FITNESS_SEMAPHORES(SEMSTATS_NAME) // names for SemStats_Print
+  DEADLOCK_MUTEX(&LCDmutex, "LCDmutex");   // mutex the detector follows
+  OS_SetQuantum(4, 10*BSP_Clock_GetFreq()/1000); // background Task7 gets 10 ms slices
+  OS_Watchdog_Init(WATCHDOGTIME, &SaveDiag);
+	OS_PeriodTrigger_Add(&TakeAccelerationData, 100, OS_PHASE_AUTO); //every 100ms
+  OS_EdgeTrigger_Register(OS_PORTD, 6, OS_EDGE_FALLING, &SwitchTouch, DEBOUNCETIME); // Button1
+#if OS_TRACE
+  UART0_Init();                      // trace and TExaS both use UART0
+  Trace_Init(TRACE_MASK_ALL);        // record all kernel events
+#elif OS_SEMSTATS || OS_DEADLOCK
+  UART0_Init();                      // SemStats_Print, Deadlock_Report and TExaS use UART0
+#else
   // when grading change 1000 to 4-digit number from edX
   TExaS_Init(GRADER, 2244);          // initialize the Lab 4 grader
 //  TExaS_Init(LOGICANALYZER, 1000); // initialize the Lab 4 logic analyzer
+#endif
   OS_Launch(BSP_Clock_GetFreq()/THREADFREQ); // doesn't return, interrupts enabled in here
   return 0;             // this never executes
 }
@@ -494,19 +537,6 @@ int main(void){
 /*          End of Step 6 Section             */
 /* ****************************************** */
 
-// Newton's method
-// s is an integer
-// sqrt(s) is an integer
-uint32_t sqrt32(uint32_t s){
-uint32_t t;   // t*t will become s
-int n;             // loop counter
-  t = s/16+1;      // initial guess
-  for(n = 16; n; --n){ // will finish
-    t = ((t*t+s)/t)/2;
-  }
-  return t;
-}
-
 
 //---------------- Step 1 ----------------
 // Step 1 is to extend OS_AddThreads from Lab 4 to handle eight
@@ -613,8 +643,7 @@ int main_step1(void){
 /* ****************************************** */
 
 //---------------- Step 2 ----------------
-// Step 2 id to extend the OS to implement OS_PeriodTrigger0_Init
-// and OS_PeriodTrigger1_Init.
+// Step 2 id to extend the OS to implement OS_PeriodTrigger_Add.
 // Task   Type           When to Run
 // TaskI  data producer  periodically every 20 ms(timer)
 // TaskJ  data consumer  after TaskI finishes
@@ -708,8 +737,8 @@ int main_step2(void){
   OS_InitSemaphore(&sIJ, 0);
   OS_InitSemaphore(&sKL, 0);
   OS_InitSemaphore(&sMN, 0);
-	OS_PeriodTrigger0_Init(&sI,20);  // every 20 ms
-	OS_PeriodTrigger1_Init(&sK,50);  // every 50ms
+	OS_PeriodTrigger_Add(&sI, 20, OS_PHASE_AUTO);  // every 20 ms
+	OS_PeriodTrigger_Add(&sK, 50, OS_PHASE_AUTO);  // every 50ms, never with sI
   OS_AddThreads(&TaskI,0, &TaskJ,1, &TaskK,2, &TaskL,3,
    	&TaskM,4, &TaskN,5, &TaskO,6, &TaskP,7);
   TExaS_Init(LOGICANALYZER, 1000); // initialize the Lab 4 grader
@@ -722,7 +751,7 @@ int main_step2(void){
 /* ****************************************** */
 
 //---------------- Step 3 ----------------
-// Step 3 is to extend the OS to implement OS_EdgeTrigger_Init
+// Step 3 is to extend the OS to implement OS_EdgeTrigger_Register
 // Task   Type           When to Run
 // TaskI  data producer  periodically every 20 ms(timer)
 // TaskJ  data consumer  after TaskI finishes
@@ -755,8 +784,6 @@ void TaskR(void){ // consumer
     TExaS_Task5();
     Profile_Toggle5();
     CountR++;
-		OS_Sleep(10);
-		OS_EdgeTrigger_Restart();
   }
 }
 int main_step3(void){
@@ -768,9 +795,9 @@ int main_step3(void){
   OS_InitSemaphore(&sIJ, 0);
   OS_InitSemaphore(&sKL, 0);
   OS_InitSemaphore(&sQR, 0);
-	OS_PeriodTrigger0_Init(&sI,50);   // every 50 ms
-	OS_PeriodTrigger1_Init(&sK,200);  // every 200ms
-	OS_EdgeTrigger_Init(&sQ,2);
+	OS_PeriodTrigger_Add(&sI, 50, OS_PHASE_AUTO);   // every 50 ms
+	OS_PeriodTrigger_Add(&sK, 200, OS_PHASE_AUTO);  // every 200ms, never with sI
+	OS_EdgeTrigger_Register(OS_PORTD, 6, OS_EDGE_FALLING, &sQ, DEBOUNCETIME);
   OS_AddThreads(&TaskI,0, &TaskJ,1, &TaskK,2, &TaskL,3,
    	&TaskQ,4, &TaskR,5, &TaskO,6, &TaskP,7);
   TExaS_Init(LOGICANALYZER, 1000); // initialize the Lab 4 grader
@@ -0,0 +1,132 @@
+// MicDMA.c
+// Runs on TM4C123
+// Timer-triggered ADC1 with uDMA ping-pong blocks, see MicDMA.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "MicDMA.h"
+#include "os.h"
+#include "BSP.h"
+#include "CortexM.h"
+#include "../inc/tm4c123gh6pm.h"
+
+#define MICCH   27           // uDMA channel of ADC1 sequencer 3, encoding 0
+#define MICBIT  (1<<MICCH)
+#define PRI     (MICCH*4)    // primary control structure, in words
+#define ALT     (128+MICCH*4)// alternate control structure
+// channel control word: 16-bit destination increment and size, 16-bit
+// source without increment, one transfer per request, ping-pong
+#define CTLWORD 0x5D000003
+#define CTLMODE 0x00000007   // transfer mode, 0 once the structure is done
+
+// uDMA channel control table, primary then alternate, for the whole
+// controller; only channel 27 is used
+uint32_t UDMATable[256] __attribute__((aligned(1024)));
+uint16_t MicBuf[2][MICBLOCKMAX]; // primary fills 0, alternate fills 1
+uint32_t MicSize;            // samples per block
+int32_t *MicSemaPt;
+uint32_t MicFilled;          // blocks filled since MicDMA_Init
+uint32_t MicTaken;           // blocks returned by MicDMA_Get
+uint32_t MicDMA_Lost;
+
+// set up one control structure to fill MicBuf[n]
+static void arm(uint32_t n){
+  uint32_t *pt = &UDMATable[n ? ALT : PRI];
+  pt[0] = (uint32_t)&ADC1_SSFIFO3_R;                  // source end
+  pt[1] = (uint32_t)&MicBuf[n][MicSize-1];            // destination end
+  pt[2] = CTLWORD|((MicSize-1)<<4);                   // XFERSIZE
+}
+
+// ******** MicDMA_Init ************
+// Start sampling the microphone into two blocks of size samples
+// Inputs:  rate, samples per second
+//          size, samples per block, 1 to MICBLOCKMAX
+//          semaPt, semaphore signaled once per full block
+// Outputs: none
+void MicDMA_Init(uint32_t rate, uint32_t size, int32_t *semaPt){
+  if(size > MICBLOCKMAX){
+    size = MICBLOCKMAX;
+  }
+  MicSize = size;
+  MicSemaPt = semaPt;
+  MicFilled = MicTaken = MicDMA_Lost = 0;
+  SYSCTL_RCGCADC_R |= 0x02;             // activate ADC1
+  SYSCTL_RCGCTIMER_R |= 0x02;           // activate Timer1
+  SYSCTL_RCGCDMA_R |= 0x01;             // activate uDMA
+  SYSCTL_RCGCGPIO_R |= 0x10;            // activate port E
+  while((SYSCTL_PRGPIO_R&0x10) == 0){};
+  GPIO_PORTE_DIR_R &= ~0x20;            // PE5 input
+  GPIO_PORTE_AFSEL_R |= 0x20;           // alt funct on PE5
+  GPIO_PORTE_DEN_R &= ~0x20;            // no digital I/O on PE5
+  GPIO_PORTE_AMSEL_R |= 0x20;           // analog on PE5, AIN8
+  while((SYSCTL_PRADC_R&0x02) == 0){};
+  ADC1_PC_R = 0x01;                     // 125 ksps is plenty
+  ADC1_ACTSS_R &= ~0x08;                // disable sequencer 3 while configuring
+  ADC1_EMUX_R = (ADC1_EMUX_R&0xFFFF0FFF)|0x5000; // sequencer 3 started by a timer
+  ADC1_SSMUX3_R = 8;                    // AIN8
+  ADC1_SSCTL3_R = 0x06;                 // one sample, IE0 END0, requests uDMA
+  ADC1_IM_R &= ~0x08;                   // no interrupt per sample, only uDMA done
+  ADC1_ISC_R = 0x08;
+  while((SYSCTL_PRDMA_R&0x01) == 0){};
+  UDMA_CFG_R = 0x01;                    // enable the uDMA controller
+  UDMA_CTLBASE_R = (uint32_t)UDMATable;
+  UDMA_CHMAP3_R &= ~0x0000F000;         // channel 27 is ADC1 sequencer 3
+  UDMA_PRIOCLR_R = MICBIT;              // default priority
+  UDMA_ALTCLR_R = MICBIT;               // start with the primary structure
+  UDMA_USEBURSTCLR_R = MICBIT;          // single and burst requests
+  UDMA_REQMASKCLR_R = MICBIT;           // allow requests from ADC1
+  arm(0);
+  arm(1);
+  UDMA_ENASET_R = MICBIT;
+  ADC1_ACTSS_R |= 0x08;                 // enable sequencer 3
+  while((SYSCTL_PRTIMER_R&0x02) == 0){};
+  TIMER1_CTL_R = 0x00000000;            // disable Timer1A during setup
+  TIMER1_CFG_R = 0x00000000;            // 32-bit mode
+  TIMER1_TAMR_R = 0x00000002;           // periodic mode, down count
+  TIMER1_TAILR_R = BSP_Clock_GetFreq()/rate - 1; // one conversion per period
+  TIMER1_TAPR_R = 0;
+  TIMER1_IMR_R = 0x00000000;            // no Timer1A interrupt
+  TIMER1_ADCEV_R = 0x01;                // timeout triggers the ADC
+  NVIC_PRI12_R = (NVIC_PRI12_R&0x00FFFFFF)|0x20000000; // priority 1, IRQ 51
+  NVIC_EN1_R = 1<<(51-32);              // enable IRQ 51 in NVIC
+  TIMER1_CTL_R = 0x00000021;            // enable Timer1A with ADC trigger output
+}
+
+// ******** MicDMA_Get ************
+// Oldest full block that has not been taken
+// Inputs:  none
+// Outputs: pointer to MicSize 12-bit samples
+uint16_t *MicDMA_Get(void){
+  uint16_t *block;
+  int32_t status = StartCritical();
+  if(MicFilled - MicTaken > 1){
+    MicTaken = MicFilled - 1;           // older ones are being refilled
+  }
+  block = MicBuf[MicTaken&1];
+  MicTaken++;
+  EndCritical(status);
+  return block;
+}
+
+// one block is full, the other structure is already filling the other
+static void blockdone(uint32_t n){
+  arm(n);                               // ready for when the other fills
+  MicFilled++;
+  if(MicFilled - MicTaken == 1){
+    OS_Signal(MicSemaPt);
+    OS_Suspend();                       // run the block's thread now
+  } else{
+    MicDMA_Lost++;                      // a block not yet taken is overwritten
+  }
+}
+
+// uDMA done on channel 27 comes in on the ADC1 sequencer 3 vector
+void ADC1Seq3_Handler(void){
+  ADC1_ISC_R = 0x08;                    // acknowledge
+  if((UDMATable[PRI+2]&CTLMODE) == 0){
+    blockdone(0);
+  }
+  if((UDMATable[ALT+2]&CTLMODE) == 0){
+    blockdone(1);
+  }
+}
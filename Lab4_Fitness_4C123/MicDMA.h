@@ -0,0 +1,41 @@
+// MicDMA.h
+// Runs on TM4C123
+// Block acquisition of the BoosterPack microphone (J1.6, PE5/AIN8).
+// Timer1A triggers ADC1 sequencer 3 at the sampling rate, and uDMA
+// channel 27 moves each conversion into one of two buffers in
+// ping-pong mode, so the CPU does nothing per sample.  The ADC1
+// sequencer 3 interrupt comes once per block: it re-arms the buffer
+// that just filled and signals a semaphore, so a thread wakes once per
+// block instead of once per sample.  Uses ADC1, not the BSP's ADC0,
+// so the accelerometer needs no mutex with it.
+// October 19, 2026
+
+#ifndef __MICDMA_H
+#define __MICDMA_H  1
+
+#define MICBLOCKMAX 1024  // largest block, in samples (uDMA limit)
+
+// ******** MicDMA_Init ************
+// Start sampling the microphone into two blocks of size samples,
+// ADC1 sequencer 3 interrupt at priority 1, IRQ 51
+// Call before OS_Launch; the first block fills size/rate seconds
+// after interrupts are enabled
+// Inputs:  rate, samples per second
+//          size, samples per block, 1 to MICBLOCKMAX
+//          semaPt, semaphore signaled once per full block
+// Outputs: none
+void MicDMA_Init(uint32_t rate, uint32_t size, int32_t *semaPt);
+
+// ******** MicDMA_Get ************
+// Oldest full block that has not been taken, call once per
+// OS_Wait on the semaphore.  The block stays valid for one block
+// time, then uDMA fills it again.  If the thread fell a whole block
+// behind, skips to the newest full block and counts the lost ones
+// in MicDMA_Lost
+// Inputs:  none
+// Outputs: pointer to size 12-bit samples
+uint16_t *MicDMA_Get(void);
+
+extern uint32_t MicDMA_Lost;  // blocks overwritten before MicDMA_Get took them
+
+#endif
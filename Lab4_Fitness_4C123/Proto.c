@@ -0,0 +1,103 @@
+// Proto.c
+// Runs on TM4C123
+// Runner for stackless cooperative tasks (protothreads), see Proto.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Proto.h"
+#include "os.h"
+#include "CortexM.h"
+
+protoType *ProtoList;     // first protothread
+uint32_t ProtoRan;        // set when a protothread gets past a wait
+int32_t ProtoEvent;       // signaled for Proto_Run through OS_Watch
+
+// ******** Proto_Add ************
+// Add a protothread, it starts at PROTO_BEGIN on the next pass of
+// Proto_Run
+// Inputs:  pt, protothread state
+//          task, protothread function
+// Outputs: none
+void Proto_Add(protoType *pt, int (*task)(protoType *pt)){
+  protoType **last;
+  int32_t status;
+  pt->next = 0;
+  pt->task = task;
+  pt->lc = 0;
+  pt->on = PROTO_ONCOND;
+  status = StartCritical();
+  last = &ProtoList;
+  while(*last){           // keep Proto_Add order
+    last = &(*last)->next;
+  }
+  *last = pt;
+  EndCritical(status);
+}
+
+// ms Proto_Run may block before a waiting protothread must be called
+// again, 0 to call them all again now
+// Watches the semaphores the protothreads wait on; one that is watched
+// for the first time may have been signaled since its OS_TryWait
+static uint32_t blocktime(void){
+  protoType *pt;
+  uint32_t ms = PROTO_BEAT;
+  int32_t left;
+  int added;
+  for(pt=ProtoList; pt; pt=pt->next){
+    if(pt->task == 0){
+      continue;
+    }
+    added = 0;
+    if(pt->on == PROTO_ONSEMA){
+      added = OS_Watch(pt->semaPt, &ProtoEvent);
+    } else if(pt->on == PROTO_ONFIFO){
+      added = OS_FIFO_Watch(&ProtoEvent);
+    } else if(pt->on == PROTO_ONSLEEP){
+      left = (int32_t)(pt->wake - OS_MsTime());
+      if(left <= 0){
+        return 0;
+      }
+      if((uint32_t)left < ms){
+        ms = left;
+      }
+    } else{
+      ms = 1;             // PROTO_WAIT_UNTIL, poll
+    }
+    if(added > 0){
+      return 0;
+    }
+    if(added < 0){
+      ms = 1;             // OS_WATCHMAX too small, poll
+    }
+  }
+  return ms;
+}
+
+// ******** Proto_Run ************
+// Main thread that runs the protothreads
+// Inputs:  none
+// Outputs: none (does not return)
+void Proto_Run(void){
+  protoType *pt;
+  uint32_t ms;
+  while(1){
+    OS_Heartbeat();
+    ProtoRan = 0;
+    for(pt=ProtoList; pt; pt=pt->next){
+      if(pt->task){
+        if(pt->lc == 0){
+          ProtoRan = 1;   // starting counts as running
+        }
+        if(pt->task(pt) == PROTO_ENDED){
+          pt->task = 0;
+        }
+      }
+    }
+    if(ProtoRan == 0){
+      ms = blocktime();   // all waiting
+      if(ms){
+        OS_WaitTimeout(&ProtoEvent, ms);
+      }
+    }
+  }
+}
@@ -0,0 +1,102 @@
+// Proto.h
+// Runs on TM4C123
+// Stackless cooperative tasks (protothreads).  A protothread is a
+// function that the runner thread, Proto_Run, calls over and over;
+// the PROTO_xxx macros make it return where it would block and jump
+// back there on the next call, using a switch on the source line.
+// All protothreads share the stack of the runner, so each costs only
+// its protoType, and dozens of small state machines fit in the RAM of
+// one kernel thread.  Proto_Run is given a thread slot like any other
+// main thread, at the priority the protothreads should run at.
+// October 19, 2026
+
+// Rules for a protothread function:
+// - local variables are lost at every PROTO_xxx wait; keep state in
+//   static variables or in a struct whose first member is protoType
+// - no switch statement around a PROTO_xxx macro, and no two of them
+//   on one source line
+// - never call OS_Wait, OS_Sleep or OS_FIFO_Get, they would stop
+//   every protothread; use PROTO_WAIT, PROTO_SLEEP and PROTO_FIFO_GET
+// When no protothread can get past its wait, Proto_Run blocks on
+// ProtoEvent until OS_Signal or OS_FIFO_Put makes something a
+// PROTO_WAIT or PROTO_FIFO_GET waits on available (OS_Watch), or the
+// earliest PROTO_SLEEP ends, or PROTO_BEAT ms pass for its heartbeat.
+// Only a PROTO_WAIT_UNTIL on any other condition is checked every ms.
+//
+//   protoType Blink;
+//   int BlinkTask(protoType *pt){
+//     PROTO_BEGIN(pt);
+//     while(1){
+//       PROTO_WAIT(pt, &Touch);
+//       BSP_RGB_D_Toggle(1, 0, 0);
+//       PROTO_SLEEP(pt, 100);
+//     }
+//     PROTO_END(pt);
+//   }
+//   Proto_Add(&Blink, &BlinkTask);   // before or after OS_Launch
+
+#ifndef __PROTO_H
+#define __PROTO_H  1
+
+#define PROTO_WAITING 0   // returned while blocked
+#define PROTO_ENDED   1   // returned when finished, it is not called again
+#define PROTO_BEAT 1000   // longest ms Proto_Run blocks, heartbeat under 3*PROTO_BEAT
+
+// what a waiting protothread waits on, so Proto_Run knows when to call it again
+#define PROTO_ONCOND  0   // PROTO_WAIT_UNTIL, any condition, check every ms
+#define PROTO_ONSEMA  1   // PROTO_WAIT, OS_Signal of semaPt
+#define PROTO_ONSLEEP 2   // PROTO_SLEEP, OS_MsTime reaching wake
+#define PROTO_ONFIFO  3   // PROTO_FIFO_GET, OS_FIFO_Put
+
+struct proto{
+  struct proto *next;             // list of protothreads, in Proto_Add order
+  int (*task)(struct proto *pt);  // 0 once it has ended
+  uint32_t lc;                    // line to resume at, 0 to start
+  uint32_t wake;                  // OS_MsTime to wake at, for PROTO_SLEEP
+  uint32_t on;                    // PROTO_ONxxx of the current wait
+  int32_t *semaPt;                // semaphore of PROTO_WAIT
+};
+typedef struct proto protoType;
+
+extern uint32_t ProtoRan; // set when a protothread gets past a wait
+extern int32_t ProtoEvent; // Proto_Run blocks on it, see OS_Watch
+
+#define PROTO_BEGIN(pt) switch((pt)->lc){ case 0:
+#define PROTO_END(pt) } (pt)->lc = 0; return PROTO_ENDED
+
+// return now and resume here once cond is true
+#define PROTO_WAIT_UNTIL(pt,cond) PROTO_WAIT_ON(pt, PROTO_ONCOND, cond)
+#define PROTO_WAIT_ON(pt,what,cond) do{ \
+  (pt)->on = (what); (pt)->lc = __LINE__; case __LINE__: \
+  if(!(cond)){ return PROTO_WAITING; } \
+  ProtoRan = 1; }while(0)
+
+// let the other protothreads run, then continue
+#define PROTO_YIELD(pt) do{ \
+  ProtoRan = 1; (pt)->lc = __LINE__; return PROTO_WAITING; case __LINE__:; }while(0)
+
+// OS_Wait, OS_Sleep and OS_FIFO_Get for protothreads
+#define PROTO_WAIT(pt,sema) do{ (pt)->semaPt = (sema); \
+  PROTO_WAIT_ON(pt, PROTO_ONSEMA, OS_TryWait((pt)->semaPt)); }while(0)
+#define PROTO_SLEEP(pt,ms) do{ (pt)->wake = OS_MsTime() + (ms); \
+  PROTO_WAIT_ON(pt, PROTO_ONSLEEP, (int32_t)(OS_MsTime() - (pt)->wake) >= 0); }while(0)
+#define PROTO_FIFO_GET(pt,dataPt) PROTO_WAIT_ON(pt, PROTO_ONFIFO, OS_FIFO_TryGet(dataPt))
+
+// ******** Proto_Add ************
+// Add a protothread, it starts at PROTO_BEGIN on the next pass of
+// Proto_Run.  pt must stay allocated (static or global)
+// Inputs:  pt, protothread state
+//          task, protothread function
+// Outputs: none
+void Proto_Add(protoType *pt, int (*task)(protoType *pt));
+
+// ******** Proto_Run ************
+// Main thread that runs the protothreads, give it a thread slot and
+// a heartbeat of about 3*PROTO_BEAT ms
+// Calls each protothread in turn and, when none of them could get
+// past its wait, blocks on ProtoEvent until one of them can
+// Inputs:  none
+// Outputs: none (does not return)
+void Proto_Run(void);
+
+#endif
@@ -0,0 +1,163 @@
+// SemStats.c
+// Runs on TM4C123
+// Per-semaphore contention statistics, printed out UART0.
+// See SemStats.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "SemStats.h"
+#include "BSP.h"
+#include "CortexM.h"
+#include "UART0.h"
+
+semStatsType SemStatsTable[SEMSTATSMAX];
+
+// entry of semaPt, or a new unnamed one, 0 if the registry is full
+// called with interrupts disabled
+static semStatsType *lookup(int32_t *semaPt){
+  int i;
+  for(i=0; i<SEMSTATSMAX; i++){
+    if(SemStatsTable[i].semaPt == semaPt){
+      return &SemStatsTable[i];
+    }
+  }
+  for(i=0; i<SEMSTATSMAX; i++){
+    if(SemStatsTable[i].semaPt == 0){
+      SemStatsTable[i].semaPt = semaPt;
+      return &SemStatsTable[i];
+    }
+  }
+  return 0;
+}
+
+// ******** SemStats_Register ************
+// Give a semaphore a name in the registry and clear its counters
+// Inputs:  semaPt, pointer to a semaphore
+//          name, string constant printed by SemStats_Print
+// Outputs: 1 if successful, 0 if the registry is full
+int SemStats_Register(int32_t *semaPt, const char *name){
+  semStatsType *pt;
+  int32_t status;
+  status = StartCritical();
+  pt = lookup(semaPt);
+  if(pt){
+    pt->name = name;
+    pt->waits = pt->blocks = 0;
+    pt->blockedSum = 0;
+    pt->blockedMax = pt->peakWaiters = 0;
+  }
+  EndCritical(status);
+  return pt != 0;
+}
+
+// ******** SemStats_Wait ************
+// Count one OS_Wait, called with interrupts disabled
+// Inputs:  semaPt, pointer to the semaphore
+// Outputs: none
+void SemStats_Wait(int32_t *semaPt){
+  semStatsType *pt = lookup(semaPt);
+  if(pt){
+    pt->waits++;
+    if(*semaPt < 0){                        // this call blocks
+      pt->blocks++;
+      if(-(*semaPt) > pt->peakWaiters){
+        pt->peakWaiters = -(*semaPt);
+      }
+    }
+  }
+}
+
+// ******** SemStats_Blocked ************
+// Add the time a thread spent blocked
+// Inputs:  semaPt, pointer to the semaphore
+//          cycles, bus cycles from blocking to running again
+// Outputs: none
+void SemStats_Blocked(int32_t *semaPt, uint32_t cycles){
+  semStatsType *pt;
+  int32_t status;
+  status = StartCritical();
+  pt = lookup(semaPt);
+  if(pt){
+    pt->blockedSum += cycles;
+    if(cycles > pt->blockedMax){
+      pt->blockedMax = cycles;
+    }
+  }
+  EndCritical(status);
+}
+
+// ******** SemStats_Get ************
+// Read one registry entry
+// Inputs:  n, entry number starting at 0
+// Outputs: pointer to the entry, 0 past the last one in use
+const semStatsType *SemStats_Get(uint32_t n){
+  if((n >= SEMSTATSMAX)||(SemStatsTable[n].semaPt == 0)){
+    return 0;
+  }
+  return &SemStatsTable[n];
+}
+
+// print n right justified in a field of width characters
+static void outudec(uint32_t n, int width){
+  char buf[10];
+  int i = 0;
+  do{
+    buf[i] = '0' + n%10;
+    n = n/10;
+    i++;
+  } while(n);
+  while(width > i){
+    UART0_OutChar(' ');
+    width--;
+  }
+  while(i){
+    i--;
+    UART0_OutChar(buf[i]);
+  }
+}
+
+// ******** SemStats_Print ************
+// Send the registry out UART0 as a text table
+// Inputs:  none
+// Outputs: none
+void SemStats_Print(void){
+  semStatsType entry;
+  uint32_t cyclesPerUs = BSP_Clock_GetFreq()/1000000;
+  int32_t status, waiting;
+  int i, n;
+  UART0_OutString("semaphore                waits   blocks    total us    max us waiting  peak\r\n");
+  for(i=0; i<SEMSTATSMAX; i++){
+    status = StartCritical();
+    entry = SemStatsTable[i];          // consistent copy
+    waiting = 0;
+    if(entry.semaPt && (*entry.semaPt < 0)){
+      waiting = -(*entry.semaPt);
+    }
+    EndCritical(status);
+    if(entry.semaPt == 0){
+      continue;
+    }
+    n = 0;
+    if(entry.name){
+      while(entry.name[n]){
+        UART0_OutChar(entry.name[n]);
+        n++;
+      }
+    } else{
+      UART0_OutString("0x");
+      UART0_OutUHex((uint32_t)(uintptr_t)entry.semaPt);
+      n = 10;
+    }
+    while(n < 22){
+      UART0_OutChar(' ');
+      n++;
+    }
+    outudec(entry.waits, 8);
+    outudec(entry.blocks, 9);
+    outudec((uint32_t)(entry.blockedSum/cyclesPerUs), 12);
+    outudec(entry.blockedMax/cyclesPerUs, 10);
+    outudec(waiting, 8);
+    outudec(entry.peakWaiters, 6);
+    UART0_OutString("\r\n");
+  }
+}
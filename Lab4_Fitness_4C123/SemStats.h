@@ -0,0 +1,92 @@
+// SemStats.h
+// Runs on TM4C123
+// Per-semaphore contention statistics.  For each semaphore the OS
+// counts the calls to OS_Wait, how many of them blocked, the total
+// and longest time a blocked thread waited (from blocking until it
+// ran again), and the most threads ever blocked on it at once.
+// A registry gives the semaphores names, and SemStats_Print dumps
+// the table out UART0 as text.
+// October 19, 2026
+
+// Set OS_SEMSTATS to 1 (e.g., OS_SEMSTATS=1 in the Keil C/C++ Define
+// box) to build the counters into the kernel.  With OS_SEMSTATS 0
+// the SEMSTATS_xxx() macros compile to nothing.
+// Note: TExaS and OS_TRACE also use UART0, so Lab4.c only starts
+// TExaS when neither is on; do not build OS_TRACE and OS_SEMSTATS
+// together, the binary trace and the text table would mix.
+
+#ifndef __SEMSTATS_H
+#define __SEMSTATS_H  1
+
+#ifndef OS_SEMSTATS
+#define OS_SEMSTATS 0
+#endif
+
+#define SEMSTATSMAX 16  // semaphores in the registry
+
+struct semstats{
+  int32_t *semaPt;     // 0 for a free entry
+  const char *name;    // 0 if never registered, printed as its address
+  uint32_t waits;      // calls to OS_Wait
+  uint32_t blocks;     // calls to OS_Wait that blocked
+  uint64_t blockedSum; // bus cycles blocked, all blocks together
+  uint32_t blockedMax; // bus cycles of the longest block
+  uint32_t peakWaiters;// most threads blocked at once
+};
+typedef struct semstats semStatsType;
+
+// ******** SemStats_Register ************
+// Give a semaphore a name in the registry and clear its counters
+// A semaphore that is waited on without being registered gets an
+// unnamed entry, as long as there is room
+// Inputs:  semaPt, pointer to a semaphore
+//          name, string constant printed by SemStats_Print
+// Outputs: 1 if successful, 0 if the registry is full
+int SemStats_Register(int32_t *semaPt, const char *name);
+
+// ******** SemStats_Wait ************
+// Count one OS_Wait, called by the OS with interrupts disabled
+// after it decrements the semaphore
+// Inputs:  semaPt, pointer to the semaphore
+// Outputs: none
+void SemStats_Wait(int32_t *semaPt);
+
+// ******** SemStats_Blocked ************
+// Add the time a thread spent blocked, called by the OS when a
+// thread that blocked in OS_Wait runs again
+// Inputs:  semaPt, pointer to the semaphore
+//          cycles, bus cycles from blocking to running again
+// Outputs: none
+void SemStats_Blocked(int32_t *semaPt, uint32_t cycles);
+
+// ******** SemStats_Get ************
+// Read one registry entry, e.g., to show it on the LCD
+// Inputs:  n, entry number starting at 0
+// Outputs: pointer to the entry, 0 past the last one in use
+const semStatsType *SemStats_Get(uint32_t n);
+
+// ******** SemStats_Print ************
+// Send the registry out UART0 as a text table, one line per
+// semaphore; times are in usec.  Waiting is the number of threads
+// blocked on it right now
+// Spins on UART0, so call it from a low priority main thread
+// UART0_Init must have been called
+// Inputs:  none
+// Outputs: none
+void SemStats_Print(void);
+
+// Use with a semaphore list (see OS_SEMAPHORE_DEFINE in os.h),
+// MY_SEMAPHORES(SEMSTATS_NAME) registers each one by its own name
+#define SEMSTATS_NAME(name, value) SEMSTATS_REGISTER(&name, #name);
+
+#if OS_SEMSTATS
+#define SEMSTATS_REGISTER(semaPt,name) SemStats_Register((semaPt),(name))
+#define SEMSTATS_WAIT(semaPt) SemStats_Wait(semaPt)
+#define SEMSTATS_BLOCKED(semaPt,cycles) SemStats_Blocked((semaPt),(cycles))
+#else
+#define SEMSTATS_REGISTER(semaPt,name)
+#define SEMSTATS_WAIT(semaPt)
+#define SEMSTATS_BLOCKED(semaPt,cycles)
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+// Srp.c
+// Runs on TM4C123
+// Stack Resource Policy jobs on a shared stack, see Srp.h.
+// SrpDispatch in osasm.s moves onto SrpStack and calls Srp_Run.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Srp.h"
+#include "CortexM.h"
+#include "../inc/tm4c123gh6pm.h"
+
+#if OS_SRP
+
+#define SRPIRQ      116     // GPIO Port P0, IRQ of level 1
+#define SRPFILL     0xBEEFCAFE
+#define BASEPRI(level) ((7-(level))<<5) // mask this level and below
+
+uint64_t SrpStack[SRPSTACKSIZE/2];     // shared job stack, 8-byte aligned
+uint32_t *const SrpStackTop = (uint32_t *)&SrpStack[SRPSTACKSIZE/2];
+srpJobType *SrpJobs[SRPLEVELS+1];      // jobs of each level, [0] unused
+
+// in osasm.s
+uint32_t SrpBasePri(void);             // read BASEPRI
+void SrpBasePriMax(uint32_t basepri);  // raise BASEPRI, never lowers it
+void SrpSetBasePri(uint32_t basepri);  // write BASEPRI
+void SrpSync(void);                    // DSB and ISB
+
+// ******** Srp_Init ************
+// Set up the job interrupts and paint the shared stack
+// Inputs:  none
+// Outputs: none
+void Srp_Init(void){
+  uint32_t i, level;
+  uint32_t *pt = (uint32_t *)SrpStack;
+  for(i=0; i<SRPSTACKSIZE; i++){
+    pt[i] = SRPFILL;
+  }
+  for(level=1; level<=SRPLEVELS; level++){   // IRQ 116-119 are bytes 0-3 of PRI29
+    i = 8*(level-1);
+    NVIC_PRI29_R = (NVIC_PRI29_R&~(0xFF<<i))|((7-level)<<(i+5));
+  }
+  NVIC_EN3_R = 0x0F<<(SRPIRQ-96);     // enable IRQ 116-119
+}
+
+// ******** Srp_Job ************
+// Add a run-to-completion job
+// Inputs:  jobPt, job state
+//          job, function run once per release
+//          level, preemption level, 1 to SRPLEVELS
+// Outputs: 1 if successful, 0 if level is out of range
+int Srp_Job(srpJobType *jobPt, void (*job)(void), uint32_t level){
+  srpJobType **last;
+  int32_t status;
+  if((level == 0)||(level > SRPLEVELS)){
+    return 0;
+  }
+  jobPt->next = 0;
+  jobPt->job = job;
+  jobPt->level = level;
+  jobPt->pending = 0;
+  status = StartCritical();
+  last = &SrpJobs[level];
+  while(*last){
+    last = &(*last)->next;
+  }
+  *last = jobPt;
+  EndCritical(status);
+  return 1;
+}
+
+// ******** Srp_Uses ************
+// Declare that a job locks a resource, raising its ceiling
+// Inputs:  jobPt, job that calls Srp_Lock on the resource
+//          resPt, the resource
+// Outputs: none
+void Srp_Uses(srpJobType *jobPt, srpResourceType *resPt){
+  if(jobPt->level > resPt->ceiling){
+    resPt->ceiling = jobPt->level;
+  }
+}
+
+// ******** Srp_Release ************
+// Have a job run once
+// Inputs:  jobPt, job to run
+// Outputs: none
+void Srp_Release(srpJobType *jobPt){
+  int32_t status;
+  status = StartCritical();
+  jobPt->pending++;
+  EndCritical(status);
+  NVIC_SW_TRIG_R = SRPIRQ + jobPt->level - 1; // pend the level's interrupt
+  SrpSync();              // if it can run, it has run when this returns
+}
+
+// ******** Srp_Lock ************
+// Enter a critical section on a resource: mask jobs up to its ceiling
+// Inputs:  resPt, the resource
+// Outputs: previous mask, pass it to Srp_Unlock
+uint32_t Srp_Lock(srpResourceType *resPt){
+  uint32_t previous = SrpBasePri();
+  if(resPt->ceiling){
+    SrpBasePriMax(BASEPRI(resPt->ceiling));
+  }
+  return previous;
+}
+
+// ******** Srp_Unlock ************
+// Leave the critical section
+// Inputs:  previous mask returned by the matching Srp_Lock
+// Outputs: none
+void Srp_Unlock(uint32_t previous){
+  SrpSetBasePri(previous);   // a pended job above the old mask runs now
+}
+
+// ******** Srp_Run ************
+// Run the released jobs of one level until none is left
+// Called by SrpDispatch in osasm.s on the shared stack
+// Inputs:  level, 1 to SRPLEVELS
+// Outputs: none
+void Srp_Run(uint32_t level){
+  srpJobType *pt;
+  int32_t status;
+  int ran;
+  do{
+    ran = 0;
+    for(pt=SrpJobs[level]; pt; pt=pt->next){
+      if(pt->pending){
+        status = StartCritical();
+        pt->pending--;
+        EndCritical(status);
+        pt->job();        // higher levels may preempt it
+        ran = 1;
+      }
+    }
+  } while(ran);
+}
+
+// ******** Srp_StackUsed ************
+// Most words of SrpStack used so far
+// Inputs:  none
+// Outputs: words used
+uint32_t Srp_StackUsed(void){
+  uint32_t i = 0;
+  uint32_t *pt = (uint32_t *)SrpStack;
+  while((i < SRPSTACKSIZE)&&(pt[i] == SRPFILL)){
+    i++;
+  }
+  return SRPSTACKSIZE - i;
+}
+
+#endif
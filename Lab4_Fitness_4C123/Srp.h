@@ -0,0 +1,110 @@
+// Srp.h
+// Runs on TM4C123
+// Stack Resource Policy jobs.  A job is a void/void function that runs
+// to completion each time it is released, like the Lab 3 event
+// threads, at a preemption level from 1 to SRPLEVELS.  All jobs share
+// one stack, SrpStack, so job stack RAM is the deepest nesting of
+// jobs rather than the sum over jobs.  A resource shared by jobs gets
+// the highest level of the jobs that use it as its ceiling, and
+// Srp_Lock masks every job up to that ceiling.  So a job starts only
+// when all it may lock is free, never blocks, and waits at most one
+// critical section of a lower job: no deadlock and bounded blocking.
+// October 19, 2026
+
+// Each level is a software-triggered interrupt on a vector of a GPIO
+// port this device does not have (GPIO Port P0 to P3, IRQ 116-119).
+// Level L has NVIC priority 7-L, above SysTick (7) so jobs preempt all
+// main threads, and below the OS periodic and edge interrupts (0-2).
+// Jobs may call OS_Signal, OS_FIFO_Put, OS_TryWait and OS_MsTime,
+// never OS_Wait, OS_Sleep or OS_FIFO_Get.  Main threads may lock
+// resources too; they have level 0.
+
+// Set OS_SRP to 1 in the Keil C/C++ Define box (OS_SRP=1) and define
+// OS_SRP in the Asm Define box to build the jobs in.  With OS_SRP 0,
+// Srp.c is empty and osasm.s leaves the GPIO Port P0-P3 vectors to
+// the startup defaults, so SrpStack costs no RAM.  The benchmark
+// image (Bench.h) checks ceiling blocking when built with OS_SRP.
+//
+//   srpJobType Sample, Show;
+//   srpResourceType ADC;
+//   Srp_Init();
+//   Srp_Job(&Sample, &SampleJob, 3);   Srp_Uses(&Sample, &ADC);
+//   Srp_Job(&Show, &ShowJob, 1);       Srp_Uses(&Show, &ADC);
+//   Srp_Release(&Sample);              // from an ISR, thread or job
+//   // in ShowJob:  prev = Srp_Lock(&ADC); ... Srp_Unlock(prev);
+
+#ifndef __SRP_H
+#define __SRP_H  1
+
+#ifndef OS_SRP
+#define OS_SRP 0
+#endif
+
+#define SRPLEVELS 4         // preemption levels 1 (lowest) to 4
+#ifndef SRPSTACKSIZE
+#define SRPSTACKSIZE 256    // words in the shared job stack, even
+#endif
+
+struct srpjob{
+  struct srpjob *next;      // jobs of the same level, in Srp_Job order
+  void (*job)(void);
+  uint32_t level;           // 1 to SRPLEVELS
+  uint32_t pending;         // releases not yet run
+};
+typedef struct srpjob srpJobType;
+
+struct srpresource{
+  uint32_t ceiling;         // highest level of the jobs that use it
+};
+typedef struct srpresource srpResourceType;
+
+// ******** Srp_Init ************
+// Set up the job interrupts and paint the shared stack
+// Call once, before OS_Launch
+// Inputs:  none
+// Outputs: none
+void Srp_Init(void);
+
+// ******** Srp_Job ************
+// Add a run-to-completion job
+// Inputs:  jobPt, job state, must stay allocated (static or global)
+//          job, function run once per release
+//          level, preemption level, 1 to SRPLEVELS, higher preempts lower
+// Outputs: 1 if successful, 0 if level is out of range
+int Srp_Job(srpJobType *jobPt, void (*job)(void), uint32_t level);
+
+// ******** Srp_Uses ************
+// Declare that a job locks a resource, raising its ceiling
+// Call for every job and resource before OS_Launch
+// Inputs:  jobPt, job that calls Srp_Lock on the resource
+//          resPt, the resource
+// Outputs: none
+void Srp_Uses(srpJobType *jobPt, srpResourceType *resPt);
+
+// ******** Srp_Release ************
+// Have a job run once.  It runs at once if its level is above the
+// running job and every locked ceiling, otherwise as soon as it is
+// Callable from main threads, jobs and interrupts
+// Inputs:  jobPt, job to run
+// Outputs: none
+void Srp_Release(srpJobType *jobPt);
+
+// ******** Srp_Lock ************
+// Enter a critical section on a resource: mask jobs up to its ceiling
+// Inputs:  resPt, the resource
+// Outputs: previous mask, pass it to Srp_Unlock
+uint32_t Srp_Lock(srpResourceType *resPt);
+
+// ******** Srp_Unlock ************
+// Leave the critical section, locks must be released in reverse order
+// Inputs:  previous mask returned by the matching Srp_Lock
+// Outputs: none
+void Srp_Unlock(uint32_t previous);
+
+// ******** Srp_StackUsed ************
+// Most words of SrpStack used so far, to size SRPSTACKSIZE
+// Inputs:  none
+// Outputs: words used
+uint32_t Srp_StackUsed(void);
+
+#endif
@@ -0,0 +1,36 @@
+// TaskTable.h
+// Runs on TM4C123
+// Threads and semaphores of the Lab 4 fitness device, declared once.
+// Lab4.c expands FITNESS_TASKS with OS_TASKTABLE (see os.h) into the
+// thread stacks, their initial frames and FitnessTable, and
+// FITNESS_SEMAPHORES into the semaphores with their initial values,
+// all as initialized data, so main needs no OS_InitSemaphore calls.
+// October 19, 2026
+
+#ifndef __TASKTABLE_H
+#define __TASKTABLE_H  1
+
+// Heartbeats are about three periods; Proto_Run, which runs the Task3
+// protothread (see Proto.h), blocks at most PROTO_BEAT = 1 s at a time
+//    TASK(thread, priority, stack words, heartbeat msec)
+#define FITNESS_TASKS(TASK) \
+  TASK(Task0, 0, 100,  100) /* microphone, every 128-sample block */ \
+  TASK(Task1, 1, 100,  300) /* accelerometer, every 100 ms */ \
+  TASK(Task2, 2, 100,  300) /* steps and plot, after Task1 */ \
+  TASK(Proto_Run, 3, 100, 3000) /* protothreads: Task3 button and buzzer */ \
+  TASK(Task4, 3, 100, 3000) /* temperature, every 1 s */ \
+  TASK(Task5, 3, 100, 3000) /* numbers on the LCD, every 1 s */ \
+  TASK(Task6, 3, 100, 2400) /* light, every 800 ms */ \
+  TASK(Task7, 4, 100,  100) /* background, every 10 ms */
+
+//    SEMAPHORE(name, initial value)
+#define FITNESS_SEMAPHORES(SEMAPHORE) \
+  SEMAPHORE(NewData, 0)              /* new numbers to display on top of LCD */ \
+  SEMAPHORE(LCDmutex, 1)             /* exclusive access to LCD */ \
+  SEMAPHORE(SoundBlock, 0)           /* signaled by ADC1 per block, MicDMA.h */ \
+  SEMAPHORE(TakeAccelerationData, 0) /* signaled by OS every 100 ms */ \
+  SEMAPHORE(SwitchTouch, 0)          /* signaled on touch button1 */ \
+  SEMAPHORE(TempDone, 0)             /* TempRead finished, I2CQ.h */ \
+  SEMAPHORE(LightDone, 0)            /* LightRead finished, I2CQ.h */
+
+#endif
@@ -0,0 +1,122 @@
+// Trace.c
+// Runs on TM4C123
+// In-RAM kernel event trace, streamed out UART0 in binary.
+// See Trace.h for the record and frame formats.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Trace.h"
+#include "os.h"
+#include "CortexM.h"
+#include "UART0.h"
+
+#define TSIZE      256  // number of events in the ring, must be a power of 2
+#define TFRAMEMAX  64   // maximum number of events sent in one frame
+struct traceevent{
+  uint32_t time;     // OS_TimeNow, low 32 bits
+  uint8_t  type;     // TRACE_xxx
+  uint8_t  thread;   // 0 to 14, TRACE_NOTHREAD
+  uint16_t arg;
+};
+typedef struct traceevent traceType;
+traceType TraceRing[TSIZE];
+uint32_t TracePutI;   // incremented by Trace_Record, never wraps into TraceGetI
+uint32_t TraceGetI;   // incremented by Trace_Flush
+uint32_t TraceMask;   // bit n set means record type n
+uint32_t TraceLost;   // events dropped since the last frame
+
+// ******** Trace_Init ************
+// Empty the trace ring, call after OS_Init
+// Inputs:  mask, bit n set means record events of type n
+// Outputs: none
+void Trace_Init(uint32_t mask){
+  TracePutI = TraceGetI = 0;
+  TraceLost = 0;
+  TraceMask = mask;
+}
+
+// ******** Trace_Record ************
+// Add one event to the trace ring, callable from threads and ISRs
+// If the ring is full, the event is counted and discarded
+// Inputs:  type, TRACE_SWITCH ... TRACE_FIFODROP
+//          thread, thread number (0 to 14) or TRACE_NOTHREAD
+//          arg, 16-bit argument
+// Outputs: none
+void Trace_Record(uint32_t type, uint32_t thread, uint32_t arg){
+  traceType *pt;
+  int32_t status;
+  if((TraceMask&(1<<type)) == 0){
+    return;
+  }
+  status = StartCritical();
+  if((TracePutI - TraceGetI) >= TSIZE){
+    TraceLost++;                   // full, keep the oldest events
+  } else{
+    pt = &TraceRing[TracePutI&(TSIZE-1)];
+    pt->time = (uint32_t)OS_TimeNow(); // same clock as the rest of the OS
+    pt->type = type;
+    pt->thread = thread;
+    pt->arg = arg;
+    TracePutI++;
+  }
+  EndCritical(status);
+}
+
+// send n as 7-bit groups, least significant first
+static void outvarint(uint32_t n){
+  while(n >= 0x80){
+    UART0_OutChar((char)((n&0x7F)|0x80));
+    n = n>>7;
+  }
+  UART0_OutChar((char)n);
+}
+
+// ******** Trace_Flush ************
+// Send all events recorded so far out UART0 as binary frames
+// Spins on UART0, so call it from a low priority main thread
+// Inputs:  none
+// Outputs: number of events sent
+uint32_t Trace_Flush(void){
+  traceType event;
+  uint32_t count, lost, last, sent;
+  int32_t status;
+  sent = 0;
+  while(TracePutI != TraceGetI){
+    count = TracePutI - TraceGetI;
+    if(count > TFRAMEMAX){
+      count = TFRAMEMAX;
+    }
+    status = StartCritical();
+    lost = TraceLost;
+    TraceLost = 0;
+    EndCritical(status);
+    event = TraceRing[TraceGetI&(TSIZE-1)];
+    UART0_OutChar('T');
+    UART0_OutChar('R');
+    UART0_OutChar((char)(count + 1 + (lost != 0)));
+    // every frame starts with the absolute time of its first event
+    UART0_OutChar((char)(TRACE_SYNC<<4));
+    UART0_OutChar((char)event.time);
+    UART0_OutChar((char)(event.time>>8));
+    UART0_OutChar((char)(event.time>>16));
+    UART0_OutChar((char)(event.time>>24));
+    outvarint(0);
+    if(lost){
+      UART0_OutChar((char)((TRACE_LOST<<4)|TRACE_NOTHREAD));
+      outvarint(0);
+      outvarint(lost);
+    }
+    last = event.time;
+    while(count){
+      event = TraceRing[TraceGetI&(TSIZE-1)];
+      UART0_OutChar((char)((event.type<<4)|(event.thread&0x0F)));
+      outvarint(event.time - last);
+      outvarint(event.arg);
+      last = event.time;
+      TraceGetI++;             // slot can now be reused by Trace_Record
+      count--;
+      sent++;
+    }
+  }
+  return sent;
+}
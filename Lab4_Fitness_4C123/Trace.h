@@ -0,0 +1,80 @@
+// Trace.h
+// Runs on TM4C123
+// In-RAM kernel event trace.  The OS records context switches,
+// semaphore waits and signals, ISR entry and exit, and FIFO drops,
+// each stamped with the OS clock (OS_TimeNow).  A background
+// thread streams the ring out UART0 in a compact binary encoding,
+// and Host/trace2chrome.py turns the stream into Chrome trace JSON.
+// October 19, 2026
+
+// Set OS_TRACE to 1 (e.g., OS_TRACE=1 in the Keil C/C++ Define box)
+// to build the trace into the kernel.  With OS_TRACE 0 every
+// TRACE_EVENT() compiles to nothing.
+// Note: TExaS also uses UART0, so do not stream the trace while
+// TExaS_Init has been called in GRADER or LOGICANALYZER mode.
+
+#ifndef __TRACE_H
+#define __TRACE_H  1
+
+#ifndef OS_TRACE
+#define OS_TRACE 0
+#endif
+
+// event types, stored in the upper 4 bits of the first byte of a record
+#define TRACE_SYNC      0  // absolute 32-bit time stamp, first record of each frame
+#define TRACE_SWITCH    1  // thread switched in, arg is previous thread
+#define TRACE_WAIT      2  // OS_Wait called, arg is semaphore
+#define TRACE_BLOCK     3  // OS_Wait blocked the caller, arg is semaphore
+#define TRACE_SIGNAL    4  // OS_Signal called, arg is semaphore
+#define TRACE_ISRENTER  5  // OS interrupt handler started, arg is TRACE_ISR_xxx
+#define TRACE_ISREXIT   6  // OS interrupt handler finished, arg is TRACE_ISR_xxx
+#define TRACE_FIFODROP  7  // OS_FIFO_Put found the FIFO full, arg is LostData
+#define TRACE_LOST      8  // records dropped because the ring was full, arg is count
+
+// ISR identifiers used as the arg of TRACE_ISRENTER/TRACE_ISREXIT
+#define TRACE_ISR_SLEEP     0  // runperiodicevents, 1 kHz sleep timer
+#define TRACE_ISR_PERIODIC  1  // RealTimeEvents, periodic triggers
+#define TRACE_ISR_EDGE      2  // GPIO edge dispatcher, OS_EdgeTrigger_Register
+#define TRACE_ISR_WAKEUP    3  // WakeupHandler, OS_SleepUs timer
+
+// thread number recorded for events that do not belong to a thread
+#define TRACE_NOTHREAD 15
+
+#define TRACE_MASK_ALL 0xFFFF
+
+// ******** Trace_Init ************
+// Empty the trace ring, call after OS_Init
+// Inputs:  mask, bit n set means record events of type n
+// Outputs: none
+void Trace_Init(uint32_t mask);
+
+// ******** Trace_Record ************
+// Add one event to the trace ring, callable from threads and ISRs
+// If the ring is full, the event is counted and discarded
+// Inputs:  type, TRACE_SWITCH ... TRACE_FIFODROP
+//          thread, thread number (0 to 14) or TRACE_NOTHREAD
+//          arg, 16-bit argument (semaphores are recorded by address
+//               offset into SRAM)
+// Outputs: none
+void Trace_Record(uint32_t type, uint32_t thread, uint32_t arg);
+
+// ******** Trace_Flush ************
+// Send all events recorded so far out UART0 as binary frames
+// Spins on UART0, so call it from a low priority main thread
+// UART0_Init must have been called
+// Frame: 'T' 'R' count, then count records; each record is
+//   (type<<4)+thread, then for TRACE_SYNC the 32-bit time, little endian,
+//   otherwise the cycles since the previous record as a varint,
+//   then arg as a varint (7 bits per byte, least significant first,
+//   bit 7 set on all but the last byte)
+// Inputs:  none
+// Outputs: number of events sent
+uint32_t Trace_Flush(void);
+
+#if OS_TRACE
+#define TRACE_EVENT(type,thread,arg) Trace_Record((type),(thread),(arg))
+#else
+#define TRACE_EVENT(type,thread,arg)
+#endif
+
+#endif
@@ -7,34 +7,125 @@
 // Hint: Copy solutions from Lab 3 into Lab 4
 #include <stdint.h>
 #include "os.h"
+#include "osport.h"
 #include "CortexM.h"
 #include "BSP.h"
+#include "Trace.h"
+#include "SemStats.h"
+#include "Deadlock.h"
 #include "../inc/tm4c123gh6pm.h"
 
-// function definitions in osasm.s
-void StartOS(void);
-
-#define NUMTHREADS  8        // maximum number of threads
+#define NUMTHREADS  OS_MAXTHREADS // maximum number of threads
+#define IDLE        NUMTHREADS // tcbs[IDLE] is the kernel idle thread
 #define NUMPERIODIC 2        // maximum number of periodic threads
 #define STACKSIZE   100      // number of 32-bit words in stack per thread
+#define NUMPRIORITIES 8      // priorities 0 to 7; the idle thread is below all of them
+// the TCB holds what the scheduler does not need to look at;
+// the scheduling state of thread i is in State[i], Priority[i],
+// Blocked[i] and Wake[i] below
 struct tcb{
   int32_t *sp;       // pointer to stack (valid for threads not running
-  struct tcb *next;  // linked-list pointer
-	int32_t *blocked;	 // nonzero if blocked on this semaphore
-  int32_t sleeping; // nonzero if this thread is sleeping
-	int32_t priority;
+  uint32_t slice;    // bus cycles left in this thread's time slice, 0 for a new slice
+  int32_t *lastwait; // last semaphore passed to OS_Wait, for the watchdog record
+  uint32_t heartbeat;// msec allowed between OS_Heartbeat calls, 0 if not monitored
+  uint32_t lastbeat; // MsTime of the last OS_Heartbeat
+  uint32_t timedout; // set when the time of OS_WaitTimeout ran out
+  int32_t *stack;    // lowest word of its stack
+  int32_t *stacktop; // one past the highest word of its stack
 };
 typedef struct tcb tcbType;
-tcbType tcbs[NUMTHREADS];
-tcbType *RunPt;
-int32_t Stacks[NUMTHREADS][STACKSIZE];
+void static idle(void);
+// kernel idle thread stack, with its initial frame in place
+struct{ int32_t space[STACKSIZE - OSPORT_FRAMEWORDS]; osFrameType frame; } IdleStack =
+  {{0}, OSPORT_FRAME(&idle)};
+tcbType tcbs[NUMTHREADS+1] = {
+  {0}, {0}, {0}, {0}, {0}, {0}, {0}, {0},
+  {(int32_t *)&IdleStack.frame}  // IDLE
+};
+tcbType *RunPt = &tcbs[0];                   // thread 0 will run first
+int32_t Stacks[NUMTHREADS][STACKSIZE];       // for OS_AddThreads
 void static runperiodicevents(void);
+void static edgerearm(void);
+uint32_t EdgeDisarmed;  // pins waiting out their debounce time
+
+// Scheduling state in parallel arrays indexed like tcbs[], so the
+// Scheduler and the 1 ms tick read a few contiguous bytes instead of
+// following next pointers through the TCBs.  The round robin order
+// is the index order; the idle thread, IDLE, is not in it
+#if NUMTHREADS != 8
+#error "the ready bitmaps are one byte, a bit for each of 8 threads"
+#endif
+#define BLOCKED  0x01        // waiting on Blocked[i]
+#define SLEEPMS  0x02        // asleep until MsTime reaches Wake[i]
+#define SLEEPUS  0x04        // asleep until the sleep timer reaches Wake[i]
+#define UNUSED   0x08        // slot without a thread
+uint8_t State[NUMTHREADS+1] = {  // 0 if ready to run
+  UNUSED, UNUSED, UNUSED, UNUSED, UNUSED, UNUSED, UNUSED, UNUSED, 0};
+uint8_t Priority[NUMTHREADS+1] = {  // 0 highest
+  0, 0, 0, 0, 0, 0, 0, 0, NUMPRIORITIES};
+uint8_t ReadyPri[NUMPRIORITIES]; // bit i set if thread i is ready, one byte per priority
+uint8_t ReadyPris;               // bit p set if ReadyPri[p] is not 0
+int32_t *Blocked[NUMTHREADS];    // semaphore a BLOCKED thread waits on
+uint32_t Wake[NUMTHREADS];       // MsTime (SLEEPMS) or sleep timer count (SLEEPUS) to wake at
+
+// index of the lowest set bit of a byte, 0 for 0
+const uint8_t LowestBit[256] = {
+  0,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  6,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  7,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  6,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0,
+  5,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0, 4,0,1,0,2,0,1,0,3,0,1,0,2,0,1,0
+};
+
+// bring the ready bitmaps up to date after State[i] changed
+// called with interrupts disabled
+static void setready(uint32_t i){
+  uint32_t p = Priority[i];
+  if(State[i] == 0){
+    ReadyPri[p] |= 1<<i;
+    ReadyPris |= 1<<p;
+  } else{
+    ReadyPri[p] &= ~(1<<i);
+    if(ReadyPri[p] == 0){
+      ReadyPris &= ~(1<<p);
+    }
+  }
+}
+
+// rebuild the ready bitmaps from State[] and Priority[]
+static void readyall(void){
+  for (int p=0; p<NUMPRIORITIES; p++){
+    ReadyPri[p] = 0;
+  }
+  ReadyPris = 0;
+  for (int i=0; i<NUMTHREADS; i++){
+    setready(i);
+  }
+}
+
+uint32_t Quantum[NUMPRIORITIES]; // time slice of each priority in bus cycles, 0 for LaunchSlice
+uint32_t LaunchSlice;            // time slice given to OS_Launch
+int32_t Yielding;                // nonzero if the next Scheduler call is not a slice expiring
 
-// Pointers (Used in scheduler to point to RunPt and serach for next best RunPt)
-tcbType *pt, *bestpt;
+uint32_t CyclesPerUs;            // sleep timer counts per microsecond
+uint32_t MsTime;                 // msec since OS_Init, counted by runperiodicevents
+uint32_t TimeHigh;               // upper 32 bits of OS_TimeNow
+uint32_t TimeLast;               // sleep timer count at the last OS_TimeNow
 
-// Variables
-int32_t max_priority;
+uint32_t LastRun = NUMTHREADS-1;  // last thread other than idle to run, round robin restarts after it
+uint64_t IdleCycles;             // total bus cycles spent in the idle thread
+uint64_t IdleStart;              // OS_TimeNow when the idle thread last started running
+uint64_t WindowStart, WindowIdle;// OS_TimeNow and IdleCycles at the start of this load window
+static uint32_t CPULoad;         // busy time in 0.1% over the last second
+
+#define STACKFILL 0xBEEFCAFE     // unused stack words hold this, for the stack high water mark
+uint32_t WatchdogOn;             // nonzero after OS_Watchdog_Init
+uint32_t WatchdogTripped;        // nonzero once a heartbeat was missed; no more feeding
+void (*WatchdogSave)(osDiagType *record);
+osDiagType Diag;                 // record of the first missed heartbeat
 
 // ******** OS_Init ************
 // Initialize operating system, disable interrupts
@@ -48,37 +139,42 @@ void OS_Init(void){
 // perform any initializations needed, 
 // set up periodic timer to run runperiodicevents to implement sleeping
 	BSP_PeriodicTask_Init(&runperiodicevents, 1000, 0);
-  
+  CyclesPerUs = BSP_Clock_GetFreq()/1000000;
+  MsTime = 0;
+  TimeHigh = TimeLast = 0;
+  OSPort_TimerInit();     // free-running timer for OS_SleepUs and OS_TimeNow
+
+}
+
+// fill the unused part of a new thread's stack, for the high water mark
+void static paint(int i){
+	for (int32_t *pt=tcbs[i].stack; pt<tcbs[i].sp; pt++){
+		*pt = STACKFILL;
+	}
 }
 
-void SetInitialStack(int i){
+void SetInitialStack(int i, void(*thread)(void)){
   // ****IMPLEMENT THIS**** 
   // **Same as Lab 2 and Lab 3****
-	tcbs[i].sp = &Stacks[i][STACKSIZE-16]; // thread stack pointer
-  Stacks[i][STACKSIZE-1] = 0x01000000;   // thumb bit
-  Stacks[i][STACKSIZE-3] = 0x14141414;   // R14
-  Stacks[i][STACKSIZE-4] = 0x12121212;   // R12
-  Stacks[i][STACKSIZE-5] = 0x03030303;   // R3
-  Stacks[i][STACKSIZE-6] = 0x02020202;   // R2
-  Stacks[i][STACKSIZE-7] = 0x01010101;   // R1
-  Stacks[i][STACKSIZE-8] = 0x00000000;   // R0
-  Stacks[i][STACKSIZE-9] = 0x11111111;   // R11
-  Stacks[i][STACKSIZE-10] = 0x10101010;  // R10
-  Stacks[i][STACKSIZE-11] = 0x09090909;  // R9
-  Stacks[i][STACKSIZE-12] = 0x08080808;  // R8
-  Stacks[i][STACKSIZE-13] = 0x07070707;  // R7
-  Stacks[i][STACKSIZE-14] = 0x06060606;  // R6
-  Stacks[i][STACKSIZE-15] = 0x05050505;  // R5
-  Stacks[i][STACKSIZE-16] = 0x04040404;  // R4
- 
+  // frame layout is processor specific, see osport.c
+	if (thread == 0){
+		tcbs[i].sp = 0;			// unused slot
+		return;
+	}
+	tcbs[i].stack = &Stacks[i][0];
+	tcbs[i].stacktop = &Stacks[i][STACKSIZE];
+	tcbs[i].sp = OSPort_InitStack(&Stacks[i][STACKSIZE], thread); // thread stack pointer
+	paint(i);
 }
 
 //******** OS_AddThreads ***************
 // Add eight main threads to the scheduler
-// Inputs: function pointers to eight void/void main threads
+// Inputs: function pointers to eight void/void main threads,
+//           0 for an unused slot
 //         priorites for each main thread (0 highest)
 // Outputs: 1 if successful, 0 if this thread can not be added
 // This function will only be called once, after OS_Init and before OS_Launch
+// The kernel adds its own idle thread, which runs when no other can
 int OS_AddThreads(void(*thread0)(void), uint32_t p0,
                   void(*thread1)(void), uint32_t p1,
                   void(*thread2)(void), uint32_t p2,
@@ -90,53 +186,173 @@ int OS_AddThreads(void(*thread0)(void), uint32_t p0,
 // **similar to Lab 3. initialize priority field****
 	int32_t status;
   status = StartCritical();
-  tcbs[0].next = &tcbs[1]; // 0 points to 1
-  tcbs[1].next = &tcbs[2]; // 1 points to 2
-  tcbs[2].next = &tcbs[3]; // 2 points to 3
-	tcbs[3].next = &tcbs[4]; // 3 points to 4		
-  tcbs[4].next = &tcbs[5]; // 4 points to 5
-	tcbs[5].next = &tcbs[6]; // 5 points to 6	
-  tcbs[6].next = &tcbs[7]; // 6 points to 7
-	tcbs[7].next = &tcbs[0]; // 7 points to 0	
+	// the ring tcbs[i].next is fixed at compile time
 	// initialize blocked and sleeping (0 = not blocked or not sleeping)
 	for (int i=0; i<NUMTHREADS; i++){
-		tcbs[i].blocked = 0;
-		tcbs[i].sleeping = 0;
+		State[i] = 0;
+		Blocked[i] = 0;
+		tcbs[i].slice = 0;
+		tcbs[i].lastwait = 0;
+		tcbs[i].heartbeat = 0;
 	}
 	// set priority of tasks 
-  tcbs[0].priority = p0; 	
-  tcbs[1].priority = p1;  
-  tcbs[2].priority = p2;  
-	tcbs[3].priority = p3;  	
-  tcbs[4].priority = p4;  
-	tcbs[5].priority = p5;  
-  tcbs[6].priority = p6;  
-	tcbs[7].priority = p7;  
+  Priority[0] = p0; 	
+  Priority[1] = p1;  
+  Priority[2] = p2;  
+	Priority[3] = p3;  	
+  Priority[4] = p4;  
+	Priority[5] = p5;  
+  Priority[6] = p6;  
+	Priority[7] = p7;  
 	
 	// inialize the Stacks
-  SetInitialStack(0); Stacks[0][STACKSIZE-2] = (int32_t)(thread0); // PC
-  SetInitialStack(1); Stacks[1][STACKSIZE-2] = (int32_t)(thread1); // PC
-	SetInitialStack(2); Stacks[2][STACKSIZE-2] = (int32_t)(thread2); // PC
-  SetInitialStack(3); Stacks[3][STACKSIZE-2] = (int32_t)(thread3); // PC
-	SetInitialStack(4); Stacks[4][STACKSIZE-2] = (int32_t)(thread4); // PC
-  SetInitialStack(5); Stacks[5][STACKSIZE-2] = (int32_t)(thread5); // PC		
-	SetInitialStack(6); Stacks[6][STACKSIZE-2] = (int32_t)(thread6); // PC
-  SetInitialStack(7); Stacks[7][STACKSIZE-2] = (int32_t)(thread7); // PC		
-  RunPt = &tcbs[0];       // thread 0 will run first
+  SetInitialStack(0, thread0);
+  SetInitialStack(1, thread1);
+	SetInitialStack(2, thread2);
+  SetInitialStack(3, thread3);
+	SetInitialStack(4, thread4);
+  SetInitialStack(5, thread5);
+	SetInitialStack(6, thread6);
+  SetInitialStack(7, thread7);
+	for (int i=0; i<NUMTHREADS; i++){
+		if (tcbs[i].sp == 0){
+			State[i] = UNUSED;		// no thread, never runs
+		}
+	}
+	readyall();
+  EndCritical(status);
+  return 1;               // successful
+}
+
+//******** OS_AddTaskTable ***************
+// Add the threads of a table made by OS_TASKTABLE to the scheduler
+// Their stacks and initial frames are already in place, so this only
+// fills in the TCBs; slots past the end of the table stay unused
+// Inputs: table, from OS_TASKTABLE
+//         number, OS_TASKCOUNT(table)
+// Outputs: 1 if successful, 0 if the table has too many threads
+int OS_AddTaskTable(const osTaskType *table, uint32_t number){
+	int32_t status;
+	if (number > NUMTHREADS){
+		return 0;
+	}
+  status = StartCritical();
+	for (int i=0; i<number; i++){
+		tcbs[i].sp = table[i].sp;
+		tcbs[i].stack = table[i].stack;
+		tcbs[i].stacktop = table[i].sp + OSPORT_FRAMEWORDS;
+		State[i] = 0;
+		Blocked[i] = 0;
+		Priority[i] = table[i].priority;
+		tcbs[i].heartbeat = table[i].heartbeat;
+		tcbs[i].lastbeat = MsTime;
+		paint(i);
+	}
+	readyall();
   EndCritical(status);
   return 1;               // successful
 }
 
 
+// close the one-second CPU load window, called from runperiodicevents
+void static loadwindow(void){
+  uint64_t now = OS_TimeNow();
+  uint64_t window, idle;
+  if(RunPt == &tcbs[IDLE]){
+    IdleCycles += now - IdleStart;  // count the idle time so far
+    IdleStart = now;
+  }
+  window = now - WindowStart;
+  idle = IdleCycles - WindowIdle;
+  if(window){
+    CPULoad = 1000 - (uint32_t)((idle*1000)/window);
+  }
+  WindowStart = now;
+  WindowIdle = IdleCycles;
+}
+
+// fill in Diag for a thread that missed its heartbeat
+void static diagnose(int i){
+  int32_t *stackpt = tcbs[i].stack;
+  Diag.magic = OSDIAG_MAGIC;
+  Diag.time = MsTime;
+  Diag.thread = i;
+  Diag.period = tcbs[i].heartbeat;
+  Diag.late = MsTime - tcbs[i].lastbeat;
+  Diag.blocked = (uint32_t)(uintptr_t)Blocked[i];
+  Diag.lastWait = (uint32_t)(uintptr_t)tcbs[i].lastwait;
+  Diag.sleeping = 0;
+  if(State[i]&SLEEPMS){
+    Diag.sleeping = Wake[i] - MsTime;
+  } else if(State[i]&SLEEPUS){
+    Diag.sleeping = -1;
+  }
+  Diag.stackUsed = tcbs[i].stacktop - tcbs[i].sp;
+  while((stackpt < tcbs[i].stacktop)&&(*stackpt == (int32_t)STACKFILL)){
+    stackpt++;
+  }
+  Diag.stackMax = tcbs[i].stacktop - stackpt;
+}
+
+// check the heartbeats, called every msec from runperiodicevents
+// feeds the hardware watchdog only if every monitored thread is on time
+void static watchdog(void){
+  if(WatchdogTripped){
+    return;               // reset is coming
+  }
+  for (int i=0; i<NUMTHREADS; i++){
+    if ((tcbs[i].heartbeat)&&((MsTime - tcbs[i].lastbeat) > tcbs[i].heartbeat)){
+      WatchdogTripped = 1;
+      diagnose(i);
+      if(WatchdogSave){
+        WatchdogSave(&Diag);
+      }
+      return;
+    }
+  }
+  OSPort_WatchdogFeed();
+}
+
 void static runperiodicevents(void){
 // ****IMPLEMENT THIS****
 // **DECREMENT SLEEP COUNTERS
 // In Lab 4, handle periodic events in RealTimeEvents
+  TRACE_EVENT(TRACE_ISRENTER, RunPt-tcbs, TRACE_ISR_SLEEP);
+  OS_TimeNow();   // catch every wrap of the 32-bit timer
+  MsTime++;
+  if((MsTime%1000) == 0){
+    loadwindow();
+  }
   for (int i=0; i<NUMTHREADS; i++){
-		if (tcbs[i].sleeping > 0){
-			tcbs[i].sleeping--;
+		if ((State[i]&SLEEPMS)&&((int32_t)(MsTime - Wake[i]) >= 0)){
+			if (State[i]&BLOCKED){			// OS_WaitTimeout gave up, undo its decrement
+				*Blocked[i] = *Blocked[i] + 1;
+				Blocked[i] = 0;
+				tcbs[i].timedout = 1;
+			}
+			State[i] &= ~(SLEEPMS|BLOCKED);
+			setready(i);
 		}
 	}
+  if(EdgeDisarmed){
+    edgerearm();
+  }
+  if(WatchdogOn){
+    watchdog();
+  }
+  TRACE_EVENT(TRACE_ISREXIT, RunPt-tcbs, TRACE_ISR_SLEEP);
+}
+
+// full time slice for a thread
+static uint32_t quantum(uint32_t i){
+  uint32_t slice = 0;
+  if(Priority[i] < NUMPRIORITIES){
+    slice = Quantum[Priority[i]];
+  }
+  if(slice == 0){
+    slice = LaunchSlice;
+  }
+  return slice;
 }
 
 //******** OS_Launch ***************
@@ -145,30 +361,59 @@ void static runperiodicevents(void){
 // Outputs: none (does not return)
 // Errors: theTimeSlice must be less than 16,777,216
 void OS_Launch(uint32_t theTimeSlice){
-  STCTRL = 0;                  // disable SysTick during setup
-  STCURRENT = 0;               // any write to current clears it
-  SYSPRI3 =(SYSPRI3&0x00FFFFFF)|0xE0000000; // priority 7
-  STRELOAD = theTimeSlice - 1; // reload value
-  STCTRL = 0x00000007;         // enable, core clock and interrupt arm
-  StartOS();                   // start on the first task
-}
-// runs every ms
+  LaunchSlice = theTimeSlice;
+  RunPt->slice = quantum(RunPt-tcbs);
+  OSPort_Launch(RunPt->slice); // SysTick and StartOS, see osport.c
+}
+
+//******** OS_SetQuantum ***************
+// Set the time slice of the threads at one priority
+// Inputs: priority, 0 to 7
+//         quantum, bus cycles per slice, 0 means the OS_Launch slice
+// Outputs: none
+void OS_SetQuantum(uint32_t priority, uint32_t quantum){
+  if(priority < NUMPRIORITIES){
+    Quantum[priority] = quantum;
+  }
+}
+// runs every time slice, and from OS_Suspend
 void Scheduler(void){      // every time slice
 // ****IMPLEMENT THIS****
 // look at all threads in TCB list choose
 // highest priority thread not blocked and not sleeping 
 // If there are multiple highest priority (not blocked, not sleeping) run these round robin
-	pt = RunPt;
-	max_priority = 7;
-	pt = pt->next;
-	while (pt != RunPt){
-		if ((pt->blocked == 0)&&(pt->sleeping == 0)&&(pt->priority < max_priority)){
-			max_priority = pt->priority;
-			bestpt = pt;
+// If none is ready, run the idle thread
+	uint32_t run = RunPt - tcbs;
+	uint32_t start = run, best = IDLE, mask;
+	if (run == IDLE){
+		start = LastRun;				// resume round robin where it stopped
+	}
+	if (ReadyPris){
+		mask = ReadyPri[LowestBit[ReadyPris]];	// ready threads at the highest priority
+		mask = ((mask >> (start+1))|(mask << (NUMTHREADS-1-start)))&0xFF; // bit 0 is start+1
+		best = (start + 1 + LowestBit[mask])%NUMTHREADS;	// start itself comes last
+	}
+	TRACE_EVENT(TRACE_SWITCH, best, run);
+	if ((run == IDLE) != (best == IDLE)){
+		uint64_t now = OS_TimeNow();
+		if (best == IDLE){
+			IdleStart = now;			// idle starts
+		} else{
+			IdleCycles += now - IdleStart;
 		}
-		pt = pt->next;
 	}
-	RunPt = bestpt;
+	if (run != IDLE){
+		LastRun = run;
+	}
+	if(Yielding == 0){
+		RunPt->slice = 0;			// slice used up, a new one next time
+	}
+	Yielding = 0;
+	RunPt = &tcbs[best];
+	if(RunPt->slice == 0){
+		RunPt->slice = quantum(best);
+	}
+	OSPort_SetSlice(RunPt->slice);	// rest of its slice, or a full one
 }
 
 //******** OS_Suspend ***************
@@ -177,9 +422,9 @@ void Scheduler(void){      // every time slice
 // Outputs: none
 // Will be run again depending on sleep/block status
 void OS_Suspend(void){
-  STCURRENT = 0;        // any write to current clears it
-  INTCTRL = 0x04000000; // trigger SysTick
-// next thread gets a full time slice
+  RunPt->slice = OSPort_SliceLeft(); // kept for the next time it runs
+  Yielding = 1;
+  OSPort_Suspend();     // trigger SysTick
 }
 
 // ******** OS_Sleep ************
@@ -191,10 +436,194 @@ void OS_Sleep(uint32_t sleepTime){
 // ****IMPLEMENT THIS****
 // set sleep parameter in TCB, same as Lab 3
 // suspend, stops running
-	RunPt->sleeping = sleepTime;
+	int32_t status;
+	if (sleepTime){							// OS_Sleep(0) only suspends
+		status = StartCritical();
+		Wake[RunPt-tcbs] = MsTime + sleepTime;	// ready on the tick that makes MsTime equal this
+		State[RunPt-tcbs] |= SLEEPMS;
+		setready(RunPt-tcbs);
+		EndCritical(status);
+	}
 	OS_Suspend();
 }
 
+// ******** OS_MsTime ************
+// Read the OS millisecond counter
+// input:  none
+// output: msec since OS_Init
+uint32_t OS_MsTime(void){
+  return MsTime;
+}
+
+// ******** OS_SleepUntil ************
+// Sleep until the next release of a periodic thread
+// input:  lastWake, release time in msec of the previous period,
+//                   advanced to the release of this period
+//         period, msec between releases
+// output: number of releases missed, ceil((now-next)/period), 0 if the thread was on time
+uint32_t OS_SleepUntil(uint32_t *lastWake, uint32_t period){
+  uint32_t next, now, missed;
+  int32_t status;
+  status = StartCritical();
+  next = *lastWake + period;
+  now = MsTime;
+  if((int32_t)(next - now) > 0){
+    *lastWake = next;
+    Wake[RunPt-tcbs] = next;        // ready on the tick that makes MsTime equal next
+    State[RunPt-tcbs] |= SLEEPMS;
+    setready(RunPt-tcbs);
+    EndCritical(status);
+    OS_Suspend();
+    return 0;
+  }
+  missed = (now - next)/period;     // whole periods skipped
+  *lastWake = next + missed*period; // latest release at or before now
+  EndCritical(status);
+  if(now == *lastWake){
+    return missed;                  // this release is on time, just no time to sleep
+  }
+  return missed + 1;                // ceil((now-next)/period), this release is late too
+}
+
+// arm the sleep timer for the first OS_SleepUs thread to wake
+// called with interrupts disabled
+static void armwakeup(void){
+  uint32_t now = OSPort_TimerNow();
+  int32_t left, soonest = 0;
+  int first = -1;
+	for (int i=0; i<NUMTHREADS; i++){
+		if (State[i]&SLEEPUS){
+      left = (int32_t)(Wake[i] - now);
+      if((first < 0)||(left < soonest)){
+        soonest = left;
+        first = i;
+      }
+		}
+	}
+  if(first >= 0){
+    OSPort_TimerCompare(Wake[first]);
+  } else{
+    OSPort_TimerCancel();
+  }
+}
+
+// ******** OS_SleepUs ************
+// place this thread into a dormant state for a time in microseconds
+// input:  number of usec to sleep, less than 26,000,000 at 80 MHz
+// output: none
+void OS_SleepUs(uint32_t sleepTime){
+  int32_t status;
+  status = StartCritical();
+  Wake[RunPt-tcbs] = OSPort_TimerNow() + sleepTime*CyclesPerUs;
+  State[RunPt-tcbs] |= SLEEPUS;
+  setready(RunPt-tcbs);
+  armwakeup();
+  EndCritical(status);
+  OS_Suspend();
+}
+
+// sleep timer match interrupt, wakes OS_SleepUs threads whose time has come
+// runs the scheduler if one of them outranks the running thread
+void WakeupHandler(void){int preempt = 0;
+  uint32_t now = OSPort_TimerNow();
+  TRACE_EVENT(TRACE_ISRENTER, RunPt-tcbs, TRACE_ISR_WAKEUP);
+	for (int i=0; i<NUMTHREADS; i++){
+		if ((State[i]&SLEEPUS)&&((int32_t)(Wake[i] - now) <= 0)){
+			State[i] &= ~SLEEPUS;
+			setready(i);
+      if(Priority[i] < Priority[RunPt-tcbs]){
+        preempt = 1;
+      }
+		}
+	}
+  armwakeup();
+  if(preempt){
+    OS_Suspend();
+  }
+  TRACE_EVENT(TRACE_ISREXIT, RunPt-tcbs, TRACE_ISR_WAKEUP);
+}
+
+// ******** OS_TimeNow ************
+// Read the OS clock, bus cycles since OS_Init
+// Called at least once per wrap of the sleep timer (runperiodicevents
+// calls it every ms), so a smaller count than last time means it wrapped
+// input:  none
+// output: 64-bit time in bus cycles
+uint64_t OS_TimeNow(void){
+  uint32_t now;
+  uint64_t time;
+  int32_t status;
+  status = StartCritical();
+  now = OSPort_TimerNow();
+  if(now < TimeLast){
+    TimeHigh++;
+  }
+  TimeLast = now;
+  time = ((uint64_t)TimeHigh<<32)|now;
+  EndCritical(status);
+  return time;
+}
+
+// kernel idle thread, always ready, lowest priority
+// sleeps until the next interrupt; runperiodicevents is at most
+// 1 ms away, too soon for deep sleep to pay off
+void static idle(void){
+  while(1){
+    DisableInterrupts();
+    OSPort_Idle();                      // wakes on any interrupt, even while disabled
+    EnableInterrupts();
+  }
+}
+
+// ******** OS_CPULoad ************
+// Fraction of the last second spent outside the idle thread
+// input:  none
+// output: load in 0.1% units, 0 to 1000
+uint32_t OS_CPULoad(void){
+  return CPULoad;
+}
+
+// ******** OS_IdleTime ************
+// Total time spent in the idle thread
+// input:  none
+// output: bus cycles since OS_Launch, not counting the current idle period
+uint64_t OS_IdleTime(void){
+  return IdleCycles;
+}
+
+// ******** OS_Watchdog_Init ************
+// Start the hardware watchdog, fed every msec while all heartbeats are on time
+// input:  timeout, msec without a feed before the reset
+//         save, function called once with the record, 0 for none
+// output: none
+void OS_Watchdog_Init(uint32_t timeout, void(*save)(osDiagType *record)){
+  WatchdogSave = save;
+  WatchdogTripped = 0;
+  Diag.magic = 0;
+  OSPort_WatchdogInit(timeout*1000*CyclesPerUs);
+  WatchdogOn = 1;
+}
+
+// ******** OS_Heartbeat_Init ************
+// Have the watchdog monitor the calling thread
+// input:  period, msec allowed between heartbeats, 0 to stop monitoring
+// output: none
+void OS_Heartbeat_Init(uint32_t period){
+  int32_t status;
+  status = StartCritical();
+  RunPt->lastbeat = MsTime;
+  RunPt->heartbeat = period;
+  EndCritical(status);
+}
+
+// ******** OS_Heartbeat ************
+// Tell the watchdog the calling thread is still making progress
+// input:  none
+// output: none
+void OS_Heartbeat(void){
+  RunPt->lastbeat = MsTime;
+}
+
 // ******** OS_InitSemaphore ************
 // Initialize counting semaphore
 // Inputs:  pointer to a semaphore
@@ -215,16 +644,67 @@ void OS_InitSemaphore(int32_t *semaPt, int32_t value){
 void OS_Wait(int32_t *semaPt){
 // ****IMPLEMENT THIS****
 // Same as Lab 3
+#if OS_SEMSTATS
+  uint32_t blockStart;
+#endif
   DisableInterrupts();
+	TRACE_EVENT(TRACE_WAIT, RunPt-tcbs, (uint32_t)semaPt);
+	RunPt->lastwait = semaPt;
 	*semaPt = *semaPt - 1;				// decrement semaphore
+	SEMSTATS_WAIT(semaPt);
+	DEADLOCK_WAIT(semaPt, RunPt-tcbs);	// owner now, or check for a wait-for cycle
+	DEADLOCK_REPORT();						// prints the cycle if this wait can never end
 	if (*semaPt < 0){							// if semaphore is less than zero, then this thread needs to be blocked
-		RunPt->blocked = semaPt;		// to block, set address of semaphore to the RunPt->blocked field
+		Blocked[RunPt-tcbs] = semaPt;	// to block, set address of semaphore in Blocked[]
+		State[RunPt-tcbs] |= BLOCKED;
+		setready(RunPt-tcbs);
+		TRACE_EVENT(TRACE_BLOCK, RunPt-tcbs, (uint32_t)semaPt);
+#if OS_SEMSTATS
+		blockStart = OSPort_TimerNow();
+#endif
 		EnableInterrupts();
 		OS_Suspend();								// suspend thread (trigger Systick interrupt)
+		SEMSTATS_BLOCKED(semaPt, OSPort_TimerNow() - blockStart);	// running again
 	}
 	EnableInterrupts();
 }
 
+struct watch{
+  int32_t *semaPt;   // semaphore watched
+  int32_t *eventPt;  // semaphore signaled with it
+};
+typedef struct watch watchType;
+watchType Watches[OS_WATCHMAX];
+uint32_t WatchNum;     // entries of Watches[] in use
+
+// OS_Signal with interrupts already disabled, so that it can signal
+// the semaphores watching semaPt as well
+static void signal(int32_t *semaPt){
+  uint32_t i;									// search from the thread after RunPt
+	TRACE_EVENT(TRACE_SIGNAL, RunPt-tcbs, (uint32_t)semaPt);
+	*semaPt = *semaPt + 1;			// increament semaphore
+	if (*semaPt <= 0){							// if semaphore is still less or equal to zero then there was a blocked thread.  need to unblock
+		i = RunPt - tcbs;
+		if (i == IDLE){
+			i = NUMTHREADS-1;						// from an ISR that interrupted idle, start at thread 0
+		}
+		do{													// round robin order, RunPt itself last
+			i = (i+1)%NUMTHREADS;
+		} while (Blocked[i] != semaPt);
+		Blocked[i] = 0;							// found the next blocked thread from this semaphore and unblocking
+		State[i] &= ~(BLOCKED|SLEEPMS);	// SLEEPMS if it was in OS_WaitTimeout
+		setready(i);
+		DEADLOCK_SIGNAL(semaPt, i);	// a mutex passes to thread i
+	}else{
+		DEADLOCK_SIGNAL(semaPt, -1);	// a mutex is free
+		for (i=0; i<WatchNum; i++){		// left for OS_TryWait, wake whoever polls it
+			if ((Watches[i].semaPt == semaPt)&&(*Watches[i].eventPt <= 0)){
+				signal(Watches[i].eventPt);
+			}
+		}
+	}
+}
+
 // ******** OS_Signal ************
 // Increment semaphore
 // Lab2 spinlock
@@ -234,17 +714,87 @@ void OS_Wait(int32_t *semaPt){
 void OS_Signal(int32_t *semaPt){
 // ****IMPLEMENT THIS****
 // Same as Lab 3
-  tcbType *pt;								// create a copy of RunPt
 	DisableInterrupts();
-	*semaPt = *semaPt + 1;			// increament semaphore
-	if (*semaPt <= 0){							// if semaphore is still less or equal to zero then there was a blocked thread.  need to unblock
-			pt = RunPt->next;						// RunPt copy pointing to next
-		while (pt->blocked != semaPt){			// while RunPt copy -> blocked does not equal to the address of the semaphore, continue the search for a blocked semaphore
-			pt = pt->next;										// search the next
-		}
-		pt->blocked = 0;										// found the next blocked thread from this semaphore and unblocking
+	signal(semaPt);
+	EnableInterrupts();
+}
+
+// ******** OS_TryWait ************
+// Decrement semaphore only if that leaves it zero or more
+// Inputs:  pointer to a counting semaphore
+// Outputs: 1 if decremented, 0 if the semaphore was zero or less
+int OS_TryWait(int32_t *semaPt){
+  int32_t status;
+  int got = 0;
+  status = StartCritical();
+  if(*semaPt > 0){
+    TRACE_EVENT(TRACE_WAIT, RunPt-tcbs, (uint32_t)semaPt);
+    *semaPt = *semaPt - 1;
+    SEMSTATS_WAIT(semaPt);
+    DEADLOCK_WAIT(semaPt, RunPt-tcbs);
+    got = 1;
+  }
+  EndCritical(status);
+  return got;
+}
+
+// ******** OS_WaitTimeout ************
+// OS_Wait that gives up after ms msec, leaving the semaphore as it was
+// Inputs:  pointer to a counting semaphore
+//          ms, longest wait in msec, 0 to only try
+// Outputs: 1 if decremented, 0 if the time ran out
+int OS_WaitTimeout(int32_t *semaPt, uint32_t ms){
+#if OS_SEMSTATS
+  uint32_t blockStart;
+#endif
+  if(ms == 0){
+    return OS_TryWait(semaPt);
+  }
+  DisableInterrupts();
+	TRACE_EVENT(TRACE_WAIT, RunPt-tcbs, (uint32_t)semaPt);
+	RunPt->lastwait = semaPt;
+	RunPt->timedout = 0;
+	*semaPt = *semaPt - 1;
+	SEMSTATS_WAIT(semaPt);
+	if (*semaPt < 0){							// block until signaled or runperiodicevents passes Wake
+		Blocked[RunPt-tcbs] = semaPt;
+		Wake[RunPt-tcbs] = MsTime + ms;
+		State[RunPt-tcbs] |= BLOCKED|SLEEPMS;
+		setready(RunPt-tcbs);
+		TRACE_EVENT(TRACE_BLOCK, RunPt-tcbs, (uint32_t)semaPt);
+#if OS_SEMSTATS
+		blockStart = OSPort_TimerNow();
+#endif
+		EnableInterrupts();
+		OS_Suspend();
+		SEMSTATS_BLOCKED(semaPt, OSPort_TimerNow() - blockStart);
 	}
 	EnableInterrupts();
+	return RunPt->timedout == 0;
+}
+
+// ******** OS_Watch ************
+// Also signal eventPt whenever OS_Signal leaves semaPt above zero
+// Inputs:  semaPt, semaphore to watch
+//          eventPt, semaphore to signal
+// Outputs: 1 if added, 0 if it was already watched, -1 if the table is full
+int OS_Watch(int32_t *semaPt, int32_t *eventPt){
+  int32_t status;
+  int added = -1;
+  status = StartCritical();
+  for (uint32_t i=0; i<WatchNum; i++){
+    if((Watches[i].semaPt == semaPt)&&(Watches[i].eventPt == eventPt)){
+      added = 0;
+    }
+  }
+  if((added < 0)&&(WatchNum < OS_WATCHMAX)){
+    Watches[WatchNum].semaPt = semaPt;
+    Watches[WatchNum].eventPt = eventPt;
+    WatchNum++;
+    added = 1;
+  }
+  EndCritical(status);
+  return added;
 }
 
 #define FSIZE 10    // can be any size
@@ -252,6 +802,7 @@ uint32_t PutI;      // index of where to put next
 uint32_t GetI;      // index of where to get next
 uint32_t Fifo[FSIZE];
 int32_t CurrentSize;// 0 means FIFO empty, FSIZE means full
+uint32_t FifoUsed;  // slots holding data not yet read; CurrentSize is -1 while Get is blocked
 uint32_t LostData;  // number of lost pieces of data
 
 // ******** OS_FIFO_Init ************
@@ -269,6 +820,8 @@ void OS_FIFO_Init(void){
   PutI = 0;
 	GetI = 0;
 	OS_InitSemaphore(&CurrentSize, 0);
+	SEMSTATS_REGISTER(&CurrentSize, "OS_FIFO");
+	FifoUsed = 0;
 	LostData = 0;
 }
 
@@ -282,17 +835,33 @@ void OS_FIFO_Init(void){
 int OS_FIFO_Put(uint32_t data){
 // ****IMPLEMENT THIS****
 // Same as Lab 3
-	if (CurrentSize == FSIZE){				// if CurrentSize = FIFO size, then the FIFO is full and data is lost
+	int32_t status;
+	if (FifoUsed == FSIZE){						// if all slots hold unread data, then the FIFO is full and data is lost
 		LostData++;
+		TRACE_EVENT(TRACE_FIFODROP, RunPt-tcbs, LostData);
 		return (-1);										// unseccssful Put (FIFO full)
 	}else{
 		Fifo[PutI] = data;							// put data in FIFO
 		PutI = (PutI + 1) % FSIZE;				// increament PutI index.  if PutI index = FSIZE, then PutI becomes 0
+		status = StartCritical();
+		FifoUsed++;
+		EndCritical(status);
 		OS_Signal(&CurrentSize);
 		return 0;												// successful Put
 	}	
 }
 
+// remove the oldest entry, CurrentSize has already been taken
+static uint32_t fifoget(void){uint32_t data;
+	int32_t status;
+	data = Fifo[GetI];								// get data
+	GetI = (GetI + 1) % FSIZE;				// increament GetI index.  if GetI index = FSIZE, then GetI becomes 0
+	status = StartCritical();
+	FifoUsed--;												// slot can be reused by Put
+	EndCritical(status);
+	return data;
+}
+
 // ******** OS_FIFO_Get ************
 // Get an entry from the FIFO.  Consider using a unique
 // semaphore to wait on busy status if more than one thread
@@ -300,105 +869,302 @@ int OS_FIFO_Put(uint32_t data){
 // this function may interrupt itself.
 // Inputs:  none
 // Outputs: data retrieved
-uint32_t OS_FIFO_Get(void){uint32_t data;
+uint32_t OS_FIFO_Get(void){
 // ****IMPLEMENT THIS****
 // Same as Lab 3
 	OS_Wait(&CurrentSize);						// wait for data to be available
-	data = Fifo[GetI];								// get data
-	GetI = (GetI + 1) % FSIZE;				// increament GetI index.  if GetI index = FSIZE, then GetI becomes 0
-	return data;
+	return fifoget();
+}
+
+// ******** OS_FIFO_TryGet ************
+// Get an entry from the FIFO if there is one, never blocks
+// Inputs:  dataPt, where to store the entry
+// Outputs: 1 if an entry was retrieved, 0 if the FIFO was empty
+int OS_FIFO_TryGet(uint32_t *dataPt){
+  if(OS_TryWait(&CurrentSize) == 0){
+    return 0;
+  }
+  *dataPt = fifoget();
+  return 1;
+}
+
+// ******** OS_FIFO_Watch ************
+// OS_Watch for the FIFO
+// Inputs:  eventPt, semaphore to signal
+// Outputs: 1 if added, 0 if it was already watched, -1 if the table is full
+int OS_FIFO_Watch(int32_t *eventPt){
+  return OS_Watch(&CurrentSize, eventPt);
 }
 // *****periodic events****************
-int32_t *PeriodicSemaphore0;
-uint32_t Period0; // time between signals
-int32_t *PeriodicSemaphore1;
-uint32_t Period1; // time between signals
-void RealTimeEvents(void){int flag=0;
-  static int32_t realCount = -10; // let all the threads execute once
+#define PERIODHORIZON 10000 // ticks searched for an automatic phase
+struct period{
+  int32_t *semaPt;   // semaphore to signal
+  uint32_t period;   // ms between signals
+  uint32_t phase;    // release ticks are phase mod period
+  uint32_t count;    // ticks until the next release
+};
+typedef struct period periodType;
+periodType Periods[OS_PERIODMAX];
+uint32_t PeriodNum;    // entries of Periods[] in use
+uint32_t PeriodTick;   // ticks since the first release
+uint32_t PeriodDelay = 10; // let all the threads execute once
+uint32_t PeriodPeak;   // most releases in one tick
+void RealTimeEvents(void){periodType *pt;
+  uint32_t n = 0;
   // Note to students: we had to let the system run for a time so all user threads ran at least one
   // before signalling the periodic tasks
-  realCount++;
-  if(realCount >= 0){
-		if((realCount%Period0)==0){
-      OS_Signal(PeriodicSemaphore0);
-      flag = 1;
-		}
-    if((realCount%Period1)==0){
-      OS_Signal(PeriodicSemaphore1);
-      flag=1;
-		}
-    if(flag){
+  TRACE_EVENT(TRACE_ISRENTER, RunPt-tcbs, TRACE_ISR_PERIODIC);
+  if(PeriodDelay){
+    PeriodDelay--;
+  } else{
+    for(pt=Periods; pt<&Periods[PeriodNum]; pt++){
+      if(pt->count == 0){
+        OS_Signal(pt->semaPt);
+        pt->count = pt->period;
+        n++;
+      }
+      pt->count--;
+    }
+    PeriodTick++;
+    if(n){
+      if(n > PeriodPeak){
+        PeriodPeak = n;
+      }
       OS_Suspend();
     }
   }
+  TRACE_EVENT(TRACE_ISREXIT, RunPt-tcbs, TRACE_ISR_PERIODIC);
 }
-// ******** OS_PeriodTrigger0_Init ************
-// Initialize periodic timer interrupt to signal 
-// Inputs:  semaphore to signal
-//          period in ms
-// priority level at 0 (highest
-// Outputs: none
-void OS_PeriodTrigger0_Init(int32_t *semaPt, uint32_t period){
-	PeriodicSemaphore0 = semaPt;
-	Period0 = period;
-	BSP_PeriodicTask_InitC(&RealTimeEvents,1000,0);
-}
-// ******** OS_PeriodTrigger1_Init ************
-// Initialize periodic timer interrupt to signal 
-// Inputs:  semaphore to signal
+
+static uint32_t gcd(uint32_t a, uint32_t b){uint32_t r;
+  while(b){
+    r = a%b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+// phase for a new trigger of this period, see OS_PeriodTrigger_Add
+// searches one hyperperiod of all the triggers, at most PERIODHORIZON ticks
+static uint32_t autophase(uint32_t period){
+  uint32_t horizon = period;
+  uint32_t best = 0, bestPeak = 0xFFFFFFFF, bestShared = 0xFFFFFFFF;
+  uint32_t p, t, i, n, peak, shared;
+  for(i=0; i<PeriodNum; i++){
+    n = horizon/gcd(horizon, Periods[i].period);
+    if(n > PERIODHORIZON/Periods[i].period){
+      horizon = PERIODHORIZON;
+      break;
+    }
+    horizon = n*Periods[i].period;  // least common multiple
+  }
+  for(p=0; p<period; p++){
+    peak = shared = 0;
+    for(t=p; t<horizon; t=t+period){
+      n = 0;
+      for(i=0; i<PeriodNum; i++){
+        if((t%Periods[i].period) == Periods[i].phase){
+          n++;
+        }
+      }
+      shared = shared + n;
+      if(n > peak){
+        peak = n;
+      }
+    }
+    if((peak < bestPeak)||((peak == bestPeak)&&(shared < bestShared))){
+      best = p;
+      bestPeak = peak;
+      bestShared = shared;
+    }
+  }
+  return best;
+}
+
+// ******** OS_PeriodTrigger_Add ************
+// Signal a semaphore every period ms from the 1 kHz periodic timer
+// Inputs:  semaPt, semaphore to signal
 //          period in ms
-// priority level at 0 (highest
-// Outputs: none
-void OS_PeriodTrigger1_Init(int32_t *semaPt, uint32_t period){
-	PeriodicSemaphore1 = semaPt;
-	Period1 = period;
-	BSP_PeriodicTask_InitC(&RealTimeEvents,1000,0);
-}
-
-//****edge-triggered event************
-int32_t *edgeSemaphore;
-// ******** OS_EdgeTrigger_Init ************
-// Initialize button1, PD6, to signal on a falling edge interrupt
-// Inputs:  semaphore to signal
-//          priority
-// Outputs: none
-void OS_EdgeTrigger_Init(int32_t *semaPt, uint8_t priority){
-
-//***IMPLEMENT THIS***
-	SYSCTL_RCGCGPIO_R |= 0x08;		// 1) activate clock for Port D
-	edgeSemaphore = semaPt;	// allow time for clock to stabilize
-		// 2) no need to unlock PD6
-	GPIO_PORTD_AMSEL_R &= ~0x40;	// 3) disable analog on PD6
-	GPIO_PORTD_PCTL_R &= ~0x04;		// 4) configure PD6 as GPIO
-	GPIO_PORTD_DIR_R &= ~0x40;		// 5) make PD6 input
-	GPIO_PORTD_AFSEL_R &= ~0x40;	// 6) disable alt funct on PD6
-	GPIO_PORTD_PUR_R &= ~0x40;		// disable pull-up on PD6
-	GPIO_PORTD_DEN_R |= 0x40;			// 7) enable digital I/O on PD6  
-	GPIO_PORTD_IS_R &= ~0x40;			// (d) PD6 is edge-sensitive 
-	GPIO_PORTD_IBE_R &= ~0x40;		//     PD6 is not both edges 
-	GPIO_PORTD_IEV_R &= ~0x40; 		//     PD6 is falling edge event 
-	GPIO_PORTD_ICR_R |= 0x40;			// (e) clear PD6 flag
-	GPIO_PORTD_IM_R |= 0x40;			// (f) arm interrupt on PD6
-	NVIC_PRI0_R	= (NVIC_PRI0_R & 0x00FFFFFF);// priority on Port D edge trigger is NVIC_PRI0_R	31  29
-	NVIC_PRI0_R |= (priority << 29);
-	NVIC_EN0_R |= 0x08;						// enable is bit 3 in NVIC_EN0_R
- }
-
-// ******** OS_EdgeTrigger_Restart ************
-// restart button1 to signal on a falling edge interrupt
-// rearm interrupt
+//          phase in ms, 0 to period-1, or OS_PHASE_AUTO
+// Outputs: phase used, -1 if OS_PERIODMAX triggers exist or period is 0
+int32_t OS_PeriodTrigger_Add(int32_t *semaPt, uint32_t period, int32_t phase){
+  periodType *pt;
+  int32_t status;
+  if((PeriodNum == OS_PERIODMAX)||(period == 0)){
+    return -1;
+  }
+  if(phase < 0){
+    phase = autophase(period);
+  }
+  pt = &Periods[PeriodNum];
+  pt->semaPt = semaPt;
+  pt->period = period;
+  pt->phase = phase%period;
+  status = StartCritical();
+  pt->count = (pt->phase + period - PeriodTick%period)%period;
+  PeriodNum++;
+  EndCritical(status);
+  if(PeriodNum == 1){
+    BSP_PeriodicTask_InitC(&RealTimeEvents,1000,0);
+  }
+  return pt->phase;
+}
+
+// ******** OS_PeriodTrigger_Peak ************
+// Most semaphores the periodic triggers have released in one tick
 // Inputs:  none
-// Outputs: none
-void OS_EdgeTrigger_Restart(void){
-//***IMPLEMENT THIS***
-	NVIC_EN0_R |= 0x08;						// rearm interrupt 3 in NVIC
-	GPIO_PORTD_ICR_R |= 0x40;			// clear flag6
-}
-void GPIOPortD_Handler(void){
-//***IMPLEMENT THIS***
-	GPIO_PORTD_ICR_R = 0x40;			// step 1 acknowledge by clearing flag
-  OS_Signal(edgeSemaphore);			// step 2 signal semaphore (no need to run scheduler)
-  NVIC_DIS0_R |= 0x08;		 			// step 3 disarm interrupt to prevent bouncing to create multiple signals
+// Outputs: peak releases per ms since OS_Launch
+uint32_t OS_PeriodTrigger_Peak(void){
+  return PeriodPeak;
+}
+
+//****edge-triggered events************
+// GPIO port registers by offset from the port base address, so one
+// dispatcher serves every port
+#define GPIOREG(base,offset) (*((volatile uint32_t *)(uintptr_t)((base)+(offset))))
+#define GPIODATA   0x3FC   // all eight pins
+#define GPIODIR    0x400
+#define GPIOIS     0x404
+#define GPIOIBE    0x408
+#define GPIOIEV    0x40C
+#define GPIOIM     0x410
+#define GPIOMIS    0x418
+#define GPIOICR    0x41C
+#define GPIOAFSEL  0x420
+#define GPIODEN    0x51C
+#define GPIOLOCK   0x520
+#define GPIOCR     0x524
+#define GPIOAMSEL  0x528
+#define GPIOPCTL   0x52C
+#define NVICPRI(irq) (*((volatile uint8_t *)(uintptr_t)(0xE000E400+(irq)))) // priority in bits 7-5
+#define EDGEPRIORITY 2     // all GPIO edge interrupts
+const uint32_t GpioBase[6] = {
+  0x40004000, 0x40005000, 0x40006000, 0x40007000, 0x40024000, 0x40025000
+};
+const uint8_t GpioIRQ[6] = {0, 1, 2, 3, 4, 30};  // GPIO Port A-F interrupt numbers
+struct edge{
+  int32_t *semaPt;   // semaphore to signal
+  uint32_t base;     // GPIO port registers
+  uint32_t rearm;    // MsTime to sample the pin and re-arm it, while disarmed
+  uint16_t debounce; // ms, 0 to signal on every edge
+  uint8_t mask;      // pin bit
+  uint8_t port;      // OS_PORTA to OS_PORTF
+  uint8_t edge;      // OS_EDGE_FALLING, OS_EDGE_RISING or OS_EDGE_BOTH
+  uint8_t disarmed;  // 1 while waiting out the debounce time
+};
+typedef struct edge edgeType;
+edgeType Edges[OS_EDGEMAX];
+uint32_t EdgeNum;    // entries of Edges[] in use
+
+// ******** OS_EdgeTrigger_Register ************
+// Signal a semaphore on an edge of a GPIO input pin, with optional
+// debouncing that re-arms the pin by itself
+// Inputs:  port, OS_PORTA to OS_PORTF
+//          pin, 0 to 7
+//          edge, OS_EDGE_FALLING, OS_EDGE_RISING or OS_EDGE_BOTH
+//          semaPt, semaphore to signal
+//          debounceMs, time the pin is ignored after an edge, 0 for none
+// Outputs: 1 if successful, 0 if OS_EDGEMAX pins are already registered
+int OS_EdgeTrigger_Register(uint32_t port, uint32_t pin, uint32_t edge,
+                            int32_t *semaPt, uint32_t debounceMs){
+  edgeType *pt;
+  uint32_t base, mask;
+  int32_t status;
+  if((port > OS_PORTF)||(pin > 7)||(EdgeNum == OS_EDGEMAX)){
+    return 0;
+  }
+  base = GpioBase[port];
+  mask = 1<<pin;
+  SYSCTL_RCGCGPIO_R |= 1<<port;         // 1) activate clock for the port
+  while((SYSCTL_PRGPIO_R&(1<<port)) == 0){};
+  status = StartCritical();
+  pt = &Edges[EdgeNum];
+  pt->semaPt = semaPt;
+  pt->base = base;
+  pt->debounce = debounceMs;
+  pt->mask = mask;
+  pt->port = port;
+  pt->edge = edge;
+  pt->disarmed = 0;
+  EdgeNum++;
+  GPIOREG(base, GPIOLOCK) = 0x4C4F434B; // 2) unlock, only PD7 and PF0 need it
+  GPIOREG(base, GPIOCR) |= mask;
+  GPIOREG(base, GPIOAMSEL) &= ~mask;    // 3) disable analog
+  GPIOREG(base, GPIOPCTL) &= ~(0xF<<(4*pin)); // 4) configure as GPIO
+  GPIOREG(base, GPIODIR) &= ~mask;      // 5) make input
+  GPIOREG(base, GPIOAFSEL) &= ~mask;    // 6) disable alt funct
+  GPIOREG(base, GPIODEN) |= mask;       // 7) enable digital I/O
+  GPIOREG(base, GPIOIS) &= ~mask;       // edge-sensitive
+  if(edge == OS_EDGE_BOTH){
+    GPIOREG(base, GPIOIBE) |= mask;     // both edges
+  } else{
+    GPIOREG(base, GPIOIBE) &= ~mask;
+    if(edge == OS_EDGE_RISING){
+      GPIOREG(base, GPIOIEV) |= mask;   // rising edge event
+    } else{
+      GPIOREG(base, GPIOIEV) &= ~mask;  // falling edge event
+    }
+  }
+  GPIOREG(base, GPIOICR) = mask;        // clear flag
+  GPIOREG(base, GPIOIM) |= mask;        // arm interrupt
+  NVICPRI(GpioIRQ[port]) = EDGEPRIORITY<<5;
+  NVIC_EN0_R = 1<<GpioIRQ[port];        // enable the port interrupt in NVIC
+  EndCritical(status);
+  return 1;
+}
+
+// shared by the GPIO port handlers: acknowledge every registered pin
+// of the port with a pending edge, then signal at once or start its
+// debounce time
+void static edgedispatch(uint32_t port){
+  edgeType *pt;
+  uint32_t mis;
+  int32_t status;
+  TRACE_EVENT(TRACE_ISRENTER, RunPt-tcbs, TRACE_ISR_EDGE);
+  mis = GPIOREG(GpioBase[port], GPIOMIS);
+  for(pt=Edges; pt<&Edges[EdgeNum]; pt++){
+    if((pt->port == port)&&(mis&pt->mask)){
+      GPIOREG(pt->base, GPIOICR) = pt->mask; // acknowledge by clearing flag
+      if(pt->debounce == 0){
+        OS_Signal(pt->semaPt);           // no need to run scheduler
+      } else{
+        status = StartCritical();        // runperiodicevents also writes IM
+        GPIOREG(pt->base, GPIOIM) &= ~pt->mask; // disarm to ignore the bounces
+        pt->rearm = MsTime + pt->debounce;
+        pt->disarmed = 1;
+        EdgeDisarmed++;
+        EndCritical(status);
+      }
+    }
+  }
+  TRACE_EVENT(TRACE_ISREXIT, RunPt-tcbs, TRACE_ISR_EDGE);
+}
+void GPIOPortA_Handler(void){ edgedispatch(OS_PORTA); }
+void GPIOPortB_Handler(void){ edgedispatch(OS_PORTB); }
+void GPIOPortC_Handler(void){ edgedispatch(OS_PORTC); }
+void GPIOPortD_Handler(void){ edgedispatch(OS_PORTD); }
+void GPIOPortE_Handler(void){ edgedispatch(OS_PORTE); }
+void GPIOPortF_Handler(void){ edgedispatch(OS_PORTF); }
+
+// end the debounce time of pins that are due, called every msec from
+// runperiodicevents while EdgeDisarmed is nonzero
+// signals if the pin settled at the level its edge leads to
+void static edgerearm(void){
+  edgeType *pt;
+  uint32_t high;
+  for(pt=Edges; pt<&Edges[EdgeNum]; pt++){
+    if((pt->disarmed)&&((int32_t)(MsTime - pt->rearm) >= 0)){
+      high = GPIOREG(pt->base, GPIODATA)&pt->mask;
+      if((pt->edge == OS_EDGE_BOTH)||((pt->edge == OS_EDGE_RISING) == (high != 0))){
+        OS_Signal(pt->semaPt);
+      }
+      GPIOREG(pt->base, GPIOICR) = pt->mask; // drop the bounces
+      GPIOREG(pt->base, GPIOIM) |= pt->mask; // re-arm
+      pt->disarmed = 0;
+      EdgeDisarmed--;
+    }
+  }
 }
 
 
@@ -28,6 +28,8 @@
 #ifndef __OS_H
 #define __OS_H  1
 
+#define OS_MAXTHREADS 8   // threads in OS_AddThreads or OS_AddTaskTable
+
 
 // ******** OS_Init ************
 // Initialize operating system, disable interrupts
@@ -39,7 +41,9 @@ void OS_Init(void);
 
 //******** OS_AddThreads ***************
 // Add eight main threads to the scheduler
-// Inputs: function pointers to eight void/void main threads
+// The kernel adds its own idle thread, which runs when no other can
+// Inputs: function pointers to eight void/void main threads,
+//           0 for an unused slot
 //         priorites for each main thread (0 highest)
 // Outputs: 1 if successful, 0 if this thread can not be added
 // This function will only be called once, after OS_Init and before OS_Launch
@@ -52,6 +56,53 @@ int OS_AddThreads(void(*thread0)(void), uint32_t p0,
                   void(*thread6)(void), uint32_t p6,
                   void(*thread7)(void), uint32_t p7);
 
+// One thread of a thread table, see OS_TASKTABLE
+struct ostask{
+  int32_t *sp;          // initial stack pointer, at its initial stack frame
+  int32_t *stack;       // lowest word of its stack
+  uint32_t priority;    // 0 highest
+  uint32_t heartbeat;   // msec allowed between OS_Heartbeat calls, 0 if not monitored
+};
+typedef struct ostask osTaskType;
+
+// A task list is an X-macro that applies its argument to each thread,
+//   #define MY_TASKS(TASK)  TASK(Task0, 0, 100, 20)  TASK(Task1, 1, 128, 0)
+// with the thread function, its priority, its stack size in words and
+// its heartbeat period in msec (0 for none).  In one C file that
+// includes osport.h, OS_TASKTABLE(MyTable, MY_TASKS) then defines each
+// stack with its initial frame already in place, and MyTable, all as
+// initialized data; main calls OS_AddTaskTable(MyTable, OS_TASKCOUNT(MyTable)).
+// A priority over 7, a stack too small for its frame or more than
+// OS_MAXTHREADS threads is a compile error (negative array size).
+#define OS_TASK_STACK(thread, priority, stack, heartbeat) \
+  void thread(void); \
+  typedef char thread##_Check[(((priority) < 8)&&((stack) >= 2*OSPORT_FRAMEWORDS)) ? 1 : -1]; \
+  struct{ int32_t space[(stack) - OSPORT_FRAMEWORDS]; osFrameType frame; } thread##_Stack = \
+    {{0}, OSPORT_FRAME(&thread)};
+#define OS_TASK_ENTRY(thread, priority, stack, heartbeat) \
+  {(int32_t *)&thread##_Stack.frame, thread##_Stack.space, (priority), (heartbeat)},
+#define OS_TASK_ONE(thread, priority, stack, heartbeat) +1
+#define OS_TASKTABLE(table, TASKS) \
+  TASKS(OS_TASK_STACK) \
+  typedef char table##_Check[((0 TASKS(OS_TASK_ONE)) <= OS_MAXTHREADS) ? 1 : -1]; \
+  const osTaskType table[] = { TASKS(OS_TASK_ENTRY) };
+#define OS_TASKCOUNT(table) (sizeof(table)/sizeof(osTaskType))
+
+// A semaphore list is an X-macro of SEMAPHORE(name, initial value);
+// MY_SEMAPHORES(OS_SEMAPHORE_DEFINE) defines them as initialized data,
+// so they need no OS_InitSemaphore, and OS_SEMAPHORE_EXTERN declares them
+#define OS_SEMAPHORE_DEFINE(name, value) int32_t name = (value);
+#define OS_SEMAPHORE_EXTERN(name, value) extern int32_t name;
+
+//******** OS_AddTaskTable ***************
+// Add the threads of a table made by OS_TASKTABLE to the scheduler,
+// instead of OS_AddThreads; thread i of the table runs in slot i
+// The kernel adds its own idle thread, which runs when no other can
+// Inputs: table, from OS_TASKTABLE
+//         number, OS_TASKCOUNT(table)
+// Outputs: 1 if successful, 0 if the table has too many threads
+// This function will only be called once, after OS_Init and before OS_Launch
+int OS_AddTaskTable(const osTaskType *table, uint32_t number);
 
 //******** OS_Launch ***************
 // Start the scheduler, enable interrupts
@@ -60,6 +111,18 @@ int OS_AddThreads(void(*thread0)(void), uint32_t p0,
 // Errors: theTimeSlice must be less than 16,777,216
 void OS_Launch(uint32_t theTimeSlice);
 
+//******** OS_SetQuantum ***************
+// Set the time slice of the threads at one priority, so CPU-bound
+// threads can run longer between switches than interactive ones
+// A thread that gives up the CPU early keeps the rest of its slice
+// for the next time it runs
+// Call before or after OS_Launch
+// Inputs: priority, 0 to 7
+//         quantum, bus cycles per slice, 0 means the OS_Launch slice
+// Outputs: none
+// Errors: quantum must be less than 16,777,216
+void OS_SetQuantum(uint32_t priority, uint32_t quantum);
+
 //******** OS_Suspend ***************
 // Called by main thread to cooperatively suspend operation
 // Inputs: none
@@ -74,6 +137,102 @@ void OS_Suspend(void);
 // OS_Sleep(0) implements cooperative multitasking
 void OS_Sleep(uint32_t sleepTime);
 
+// ******** OS_MsTime ************
+// Read the OS millisecond counter, incremented by the 1 kHz
+// sleep timer; the time base of OS_Sleep and OS_SleepUntil
+// input:  none
+// output: msec since OS_Init, wraps after 49 days
+uint32_t OS_MsTime(void);
+
+// ******** OS_SleepUntil ************
+// Sleep until the next release of a periodic thread, so the loop
+// runs at an exact rate however long each pass takes:
+//   uint32_t lastWake = OS_MsTime();
+//   while(1){ OS_SleepUntil(&lastWake, 100); ...work... }
+// If the release has already passed (the last pass overran) the
+// thread is not put to sleep, and lastWake moves to the most recent
+// release on the grid, skipping the ones that were missed.  The count
+// is ceil((now-next)/period): every release before now, but not one
+// that is exactly now, since that pass still starts on time
+// input:  lastWake, release time in msec of the previous period,
+//                   advanced to the release of this period
+//         period, msec between releases
+// output: number of releases missed, 0 if the thread was on time
+uint32_t OS_SleepUntil(uint32_t *lastWake, uint32_t period);
+
+// ******** OS_SleepUs ************
+// place this thread into a dormant state for a time in microseconds,
+// timed by the sleep timer compare interrupt rather than the 1 ms tick
+// input:  number of usec to sleep, less than 26,000,000 at 80 MHz
+// output: none
+// Use OS_Sleep for longer times
+void OS_SleepUs(uint32_t sleepTime);
+
+// ******** OS_TimeNow ************
+// Read the OS clock, bus cycles since OS_Init
+// The 32-bit sleep timer is extended to 64 bits in software, so the
+// count never wraps; callable from main threads and ISRs
+// input:  none
+// output: 64-bit time in bus cycles (BSP_Clock_GetFreq() per second)
+uint64_t OS_TimeNow(void);
+
+// ******** OS_CPULoad ************
+// Fraction of the last second spent outside the kernel idle thread,
+// updated once a second
+// input:  none
+// output: load in 0.1% units, 0 to 1000
+uint32_t OS_CPULoad(void);
+
+// ******** OS_IdleTime ************
+// Total time spent in the kernel idle thread
+// input:  none
+// output: bus cycles since OS_Launch, not counting the current idle period
+uint64_t OS_IdleTime(void);
+
+// Diagnostic record of a missed heartbeat, see OS_Watchdog_Init
+// All words, so it can be written to flash as it is
+#define OSDIAG_MAGIC 0x57444F47   // "WDOG", marks a valid record
+struct osdiag{
+  uint32_t magic;      // OSDIAG_MAGIC
+  uint32_t time;       // OS_MsTime when the miss was found
+  uint32_t thread;     // OS_AddThreads slot, 0 to 7
+  uint32_t period;     // its heartbeat period in msec
+  uint32_t late;       // msec since its last OS_Heartbeat
+  uint32_t blocked;    // address of the semaphore it is blocked on, 0 if none
+  uint32_t lastWait;   // address of the last semaphore it passed to OS_Wait
+  int32_t sleeping;    // msec of sleep left, -1 in OS_SleepUs
+  uint32_t stackUsed;  // words of stack in use at its last context switch
+  uint32_t stackMax;   // most words of stack it has ever used
+};
+typedef struct osdiag osDiagType;
+
+// ******** OS_Watchdog_Init ************
+// Start the hardware watchdog.  The kernel feeds it every msec as
+// long as each thread that called OS_Heartbeat_Init keeps up its
+// heartbeat.  When one misses, the kernel fills in a diagnostic
+// record, passes it to save (e.g., to write it to flash) and stops
+// feeding, so the processor resets
+// Call after OS_Init and before OS_Launch
+// input:  timeout, msec without a feed before the reset, longer
+//           than save takes
+//         save, function called once with the record from the 1 ms
+//           timer interrupt, 0 for none
+// output: none
+void OS_Watchdog_Init(uint32_t timeout, void(*save)(osDiagType *record));
+
+// ******** OS_Heartbeat_Init ************
+// Have the watchdog monitor the calling thread, which must then
+// call OS_Heartbeat at least once every period
+// input:  period, msec allowed between heartbeats, 0 to stop monitoring
+// output: none
+void OS_Heartbeat_Init(uint32_t period);
+
+// ******** OS_Heartbeat ************
+// Tell the watchdog the calling thread is still making progress
+// input:  none
+// output: none
+void OS_Heartbeat(void);
+
 // ******** OS_InitSemaphore ************
 // Initialize counting semaphore
 // Inputs:  pointer to a semaphore
@@ -97,6 +256,37 @@ void OS_Wait(int32_t *semaPt);
 // Outputs: none
 void OS_Signal(int32_t *semaPt);
 
+// ******** OS_TryWait ************
+// Decrement semaphore only if that leaves it zero or more,
+// never blocks, for protothreads (Proto.h) and polling
+// Inputs:  pointer to a counting semaphore
+// Outputs: 1 if decremented, 0 if the semaphore was zero or less
+int OS_TryWait(int32_t *semaPt);
+
+// ******** OS_WaitTimeout ************
+// OS_Wait that gives up after ms msec, leaving the semaphore as it
+// was.  Not for a mutex registered with Deadlock_Mutex, the deadlock
+// detector does not see timed waits
+// Inputs:  pointer to a counting semaphore
+//          ms, longest wait in msec, 0 to only try
+// Outputs: 1 if decremented, 0 if the time ran out
+int OS_WaitTimeout(int32_t *semaPt, uint32_t ms);
+
+#ifndef OS_WATCHMAX
+#define OS_WATCHMAX 8     // watched semaphores, define it first for more
+#endif
+
+// ******** OS_Watch ************
+// From now on, whenever OS_Signal leaves semaPt above zero, also
+// signal eventPt, binary style (only if eventPt is not already above
+// zero).  Lets one thread sleep on eventPt while it polls several
+// semaphores with OS_TryWait, as Proto_Run does.  Adding a pair that
+// is already watched does nothing; eventPt must not be watched itself
+// Inputs:  semaPt, semaphore to watch
+//          eventPt, semaphore to signal
+// Outputs: 1 if added, 0 if it was already watched, -1 if the table is full
+int OS_Watch(int32_t *semaPt, int32_t *eventPt);
+
 // ******** OS_FIFO_Init ************
 // Initialize FIFO.  The "put" and "get" indices initially
 // are equal, which means that the FIFO is empty.  Also
@@ -126,34 +316,71 @@ int OS_FIFO_Put(uint32_t data);
 // Outputs: data retrieved
 uint32_t OS_FIFO_Get(void);
 
-// ******** OS_PeriodTrigger0_Init ************
-// Initialize periodic timer interrupt to signal 
-// Inputs:  semaphore to signal
-//          period in ms
-// priority level at 0 (highest)
-// Outputs: none
-void OS_PeriodTrigger0_Init(int32_t *semaPt, uint32_t period);
+// ******** OS_FIFO_TryGet ************
+// Get an entry from the FIFO if there is one, never blocks
+// Inputs:  dataPt, where to store the entry
+// Outputs: 1 if an entry was retrieved, 0 if the FIFO was empty
+int OS_FIFO_TryGet(uint32_t *dataPt);
 
-// ******** OS_PeriodTrigger1_Init ************
-// Initialize periodic timer interrupt to signal 
-// Inputs:  semaphore to signal
-//          period in ms
-// priority level at 0 (highest)
-// Outputs: none
-void OS_PeriodTrigger1_Init(int32_t *semaPt, uint32_t period);
+// ******** OS_FIFO_Watch ************
+// OS_Watch for the FIFO, signal eventPt whenever OS_FIFO_Put leaves
+// an entry that OS_FIFO_TryGet can take
+// Inputs:  eventPt, semaphore to signal
+// Outputs: 1 if added, 0 if it was already watched, -1 if the table is full
+int OS_FIFO_Watch(int32_t *eventPt);
 
-// ******** OS_EdgeTrigger_Init ************
-// Initialize button1, PD6, to signal on a falling edge interrupt
-// Inputs:  semaphore to signal
-//          priority
-// Outputs: none
-void OS_EdgeTrigger_Init(int32_t *semaPt, uint8_t priority);
+#ifndef OS_PERIODMAX
+#define OS_PERIODMAX 8    // periodic triggers, define it first for more
+#endif
+#define OS_PHASE_AUTO (-1) // let OS_PeriodTrigger_Add pick the phase
 
-// ******** OS_EdgeTrigger_Restart ************
-// restart button1 to signal on a falling edge interrupt
-// rearm interrupt
+// ******** OS_PeriodTrigger_Add ************
+// Signal a semaphore every period ms from the 1 kHz periodic timer
+// interrupt (priority 0), at ticks phase, phase+period, ...
+// counted from the first release.  With OS_PHASE_AUTO the phase is
+// chosen so this trigger shares as few ticks as possible with the
+// triggers already added: lowest peak releases per tick, then fewest
+// shared ticks, then earliest.  Add the shortest periods first.
+// Inputs:  semaPt, semaphore to signal
+//          period in ms
+//          phase in ms, 0 to period-1, or OS_PHASE_AUTO
+// Outputs: phase used, -1 if OS_PERIODMAX triggers exist or period is 0
+int32_t OS_PeriodTrigger_Add(int32_t *semaPt, uint32_t period, int32_t phase);
+
+// ******** OS_PeriodTrigger_Peak ************
+// Most semaphores the periodic triggers have released in one tick
 // Inputs:  none
-// Outputs: none
-void OS_EdgeTrigger_Restart(void);
+// Outputs: peak releases per ms since OS_Launch
+uint32_t OS_PeriodTrigger_Peak(void);
+
+// ports and edges for OS_EdgeTrigger_Register
+#define OS_PORTA 0
+#define OS_PORTB 1
+#define OS_PORTC 2
+#define OS_PORTD 3
+#define OS_PORTE 4
+#define OS_PORTF 5
+#define OS_EDGE_FALLING 0
+#define OS_EDGE_RISING  1
+#define OS_EDGE_BOTH    2
+#define OS_EDGEMAX 8      // pins that can be registered
+
+// ******** OS_EdgeTrigger_Register ************
+// Signal a semaphore on an edge of a GPIO input pin, for buttons,
+// sensor data-ready lines and the like.  All ports share one
+// dispatcher.  With debounce, the dispatcher disarms the pin on the
+// first edge and samples it debounceMs later; it signals then if the
+// pin settled at the level the edge leads to (low for falling, high
+// for rising, either for both), and re-arms the pin by itself.
+// With debounceMs 0 every edge signals at once and nothing is disarmed.
+// The pin is made a digital input; set its pull-up or pull-down first
+// Inputs:  port, OS_PORTA to OS_PORTF
+//          pin, 0 to 7
+//          edge, OS_EDGE_FALLING, OS_EDGE_RISING or OS_EDGE_BOTH
+//          semaPt, semaphore to signal
+//          debounceMs, time the pin is ignored after an edge, 0 for none
+// Outputs: 1 if successful, 0 if OS_EDGEMAX pins are already registered
+int OS_EdgeTrigger_Register(uint32_t port, uint32_t pin, uint32_t edge,
+                            int32_t *semaPt, uint32_t debounceMs);
 
 #endif
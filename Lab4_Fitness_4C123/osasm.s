@@ -17,6 +17,23 @@
         EXPORT  SysTick_Handler
         IMPORT  Scheduler
 
+        IF :LNOT::DEF:OS_SRP
+        GBLA    OS_SRP           ; 0 unless the Asm Define box sets it, Srp.h
+        ENDIF
+        IF OS_SRP <> 0
+        EXTERN  SrpStack         ; shared job stack, Srp.c
+        EXTERN  SrpStackTop
+        IMPORT  Srp_Run
+        EXPORT  GPIOPortP0_Handler
+        EXPORT  GPIOPortP1_Handler
+        EXPORT  GPIOPortP2_Handler
+        EXPORT  GPIOPortP3_Handler
+        EXPORT  SrpBasePri
+        EXPORT  SrpBasePriMax
+        EXPORT  SrpSetBasePri
+        EXPORT  SrpSync
+        ENDIF
+
 
 SysTick_Handler                ; 1) Saves R0-R3,R12,LR,PC,PSR
     CPSID   I                  ; 2) Prevent interrupt during switch
@@ -48,5 +65,59 @@ StartOS
     CPSIE   I                  ; Enable interrupts at processor level
     BX      LR                 ; start first thread
 
+        IF OS_SRP <> 0
+; SRP job levels 1-4 (Srp.h) are the vectors of GPIO Port P0-P3,
+; which the TM4C123 does not have; Srp_Release pends them
+GPIOPortP0_Handler
+    MOVS    R0, #1             ; level
+    B       SrpDispatch
+GPIOPortP1_Handler
+    MOVS    R0, #2
+    B       SrpDispatch
+GPIOPortP2_Handler
+    MOVS    R0, #3
+    B       SrpDispatch
+GPIOPortP3_Handler
+    MOVS    R0, #4
+    B       SrpDispatch
+
+; Run the jobs of level R0 on SrpStack.  The outermost job moves SP
+; from the interrupted thread's stack to the top of SrpStack; a job
+; preempting another is already on it and stays.
+SrpDispatch
+    PUSH    {R4,LR}            ; R4 will hold the interrupted SP
+    MOV     R4, SP
+    LDR     R1, =SrpStack      ; lowest address of the shared stack
+    CMP     R4, R1
+    BLO     SrpMove            ; below it
+    LDR     R2, =SrpStackTop
+    LDR     R2, [R2]
+    CMP     R4, R2
+    BLO     SrpRun             ; on it already
+SrpMove
+    LDR     R2, =SrpStackTop
+    LDR     SP, [R2]           ; SP = SrpStackTop
+SrpRun
+    BL      Srp_Run            ; Srp_Run(level)
+    MOV     SP, R4             ; back to the interrupted stack
+    POP     {R4,PC}            ; exception return
+
+; BASEPRI access for Srp_Lock and Srp_Unlock
+SrpBasePri                     ; uint32_t SrpBasePri(void)
+    MRS     R0, BASEPRI
+    BX      LR
+SrpBasePriMax                  ; void SrpBasePriMax(uint32_t basepri), only raises the mask
+    MSR     BASEPRI_MAX, R0
+    BX      LR
+SrpSetBasePri                  ; void SrpSetBasePri(uint32_t basepri)
+    MSR     BASEPRI, R0
+    ISB                        ; a job the old mask held runs before the return
+    BX      LR
+SrpSync                        ; void SrpSync(void), take a just pended job now
+    DSB
+    ISB
+    BX      LR
+        ENDIF
+
     ALIGN
     END
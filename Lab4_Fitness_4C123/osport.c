@@ -0,0 +1,210 @@
+// osport.c
+// Runs on LM4F120/TM4C123/MSP432
+// Cortex-M part of the kernel, see osport.h.
+// The context switch itself is SysTick_Handler in osasm.s.
+// October 19, 2026
+
+#include <stdint.h>
+#include "osport.h"
+#include "CortexM.h"
+#include "../inc/tm4c123gh6pm.h"
+
+// Cortex-M4 data watchpoint and trace unit
+#define DEMCR       (*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL    (*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT  (*((volatile uint32_t *)0xE0001004))
+#define DEMCR_TRCENA       0x01000000
+#define DWT_CTRL_CYCCNTENA 0x00000001
+
+#define MINSLICE 100   // shortest time slice in bus cycles
+
+#define WDT_UNLOCK  0x1ACCE551   // write to WATCHDOG0_LOCK_R to allow register writes
+
+// function definitions in osasm.s
+void StartOS(void);
+// sleep timer match, in os.c
+void WakeupHandler(void);
+
+// ******** OSPort_InitStack ************
+// Build the initial stack frame of a thread so the first context
+// switch to it starts execution at the beginning of the thread
+// Inputs:  stackEnd, one past the last (highest) word of the stack
+//          thread, pointer to a void/void main thread
+// Outputs: initial stack pointer to store in the TCB
+int32_t *OSPort_InitStack(int32_t *stackEnd, void(*thread)(void)){
+  osFrameType *frame;
+  frame = (osFrameType *)(stackEnd - 16);
+  frame->psr = 0x01000000;   // thumb bit
+  frame->pc  = thread;       // PC
+  frame->lr  = 0x14141414;   // R14
+  frame->r12 = 0x12121212;   // R12
+  frame->r3  = 0x03030303;   // R3
+  frame->r2  = 0x02020202;   // R2
+  frame->r1  = 0x01010101;   // R1
+  frame->r0  = 0x00000000;   // R0
+  frame->r11 = 0x11111111;   // R11
+  frame->r10 = 0x10101010;   // R10
+  frame->r9  = 0x09090909;   // R9
+  frame->r8  = 0x08080808;   // R8
+  frame->r7  = 0x07070707;   // R7
+  frame->r6  = 0x06060606;   // R6
+  frame->r5  = 0x05050505;   // R5
+  frame->r4  = 0x04040404;   // R4
+  return (int32_t *)frame;   // thread stack pointer
+}
+
+// ******** OSPort_Launch ************
+// Start the periodic time slice interrupt and run RunPt
+// Inputs:  number of bus cycles in each time slice
+// Outputs: none (does not return)
+// Errors: theTimeSlice must be less than 16,777,216
+void OSPort_Launch(uint32_t theTimeSlice){
+  STCTRL = 0;                  // disable SysTick during setup
+  STCURRENT = 0;               // any write to current clears it
+  SYSPRI3 =(SYSPRI3&0x00FFFFFF)|0xE0000000; // priority 7
+  STRELOAD = theTimeSlice - 1; // reload value
+  STCTRL = 0x00000007;         // enable, core clock and interrupt arm
+  StartOS();                   // start on the first task
+}
+
+// ******** OSPort_Suspend ************
+// Request a context switch; it happens as soon as interrupts are enabled
+// Inputs:  none
+// Outputs: none
+void OSPort_Suspend(void){
+  STCURRENT = 0;        // any write to current clears it
+  INTCTRL = 0x04000000; // trigger SysTick
+}
+
+// ******** OSPort_SetSlice ************
+// Restart the time slice interrupt so the running thread
+// is preempted after theTimeSlice bus cycles
+// Inputs:  number of bus cycles until the next time slice interrupt
+// Outputs: none
+void OSPort_SetSlice(uint32_t theTimeSlice){
+  if(theTimeSlice < MINSLICE){
+    theTimeSlice = MINSLICE;   // STRELOAD of 0 would stop SysTick
+  }
+  STRELOAD = theTimeSlice - 1; // reload value
+  STCURRENT = 0;               // restart the count from STRELOAD
+}
+
+// ******** OSPort_SliceLeft ************
+// Bus cycles left before the time slice interrupt
+// Inputs:  none
+// Outputs: remaining cycles, at least 1
+uint32_t OSPort_SliceLeft(void){
+  return (STCURRENT&0x00FFFFFF) + 1;
+}
+
+// ******** OSPort_Idle ************
+// Wait for an interrupt in sleep mode
+// Inputs:  none
+// Outputs: none
+void OSPort_Idle(void){
+  WaitForInterrupt();
+}
+
+// ******** OSPort_CycleInit ************
+// Start the free-running cycle counter read by OSPort_Cycles
+// Inputs:  none
+// Outputs: none
+void OSPort_CycleInit(void){
+  DEMCR |= DEMCR_TRCENA;           // enable the DWT
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA;  // cycle counter runs at the core clock
+}
+
+// ******** OSPort_Cycles ************
+// Read the free-running cycle counter
+// Inputs:  none
+// Outputs: current count
+uint32_t OSPort_Cycles(void){
+  return DWT_CYCCNT;
+}
+
+#define WTIMER2A_IRQ 98    // interrupt number of Wide Timer 2A
+
+// ******** OSPort_TimerInit ************
+// Start the free-running sleep timer, Wide Timer 2A as a 32-bit
+// up-counter at the bus clock, match interrupt at priority 2
+// Wide Timers 3A-5A belong to BSP_PeriodicTask_Init and friends, and
+// os.c runs runperiodicevents on 5A
+// Inputs:  none
+// Outputs: none
+void OSPort_TimerInit(void){
+  SYSCTL_RCGCWTIMER_R |= 0x04;     // 0) activate clock for Wide Timer 2
+  while((SYSCTL_PRWTIMER_R&0x04) == 0){};
+  WTIMER2_CTL_R = 0x00000000;      // 1) disable Wide Timer 2A during setup
+  WTIMER2_CFG_R = 0x00000004;      // 2) 32-bit timer A
+  WTIMER2_TAMR_R = 0x00000032;     // 3) periodic, count up, match interrupt
+  WTIMER2_TAILR_R = 0xFFFFFFFF;    // 4) full 32-bit range
+  WTIMER2_TAPR_R = 0;              // 5) bus clock resolution
+  WTIMER2_ICR_R = 0x00000010;      // 6) clear match flag
+  WTIMER2_IMR_R = 0x00000000;      // 7) match interrupt disarmed until needed
+  NVIC_PRI24_R = (NVIC_PRI24_R&0xFF00FFFF)|0x00400000; // 8) priority 2
+  NVIC_EN3_R = 0x00000004;         // 9) enable IRQ 98 in NVIC
+  WTIMER2_CTL_R = 0x00000001;      // 10) enable Wide Timer 2A
+}
+
+// ******** OSPort_TimerNow ************
+// Read the sleep timer
+// Inputs:  none
+// Outputs: current count
+uint32_t OSPort_TimerNow(void){
+  return WTIMER2_TAV_R;
+}
+
+// ******** OSPort_TimerCompare ************
+// Arm the sleep timer interrupt for the time the count reaches when
+// Inputs:  when, sleep timer count, less than 2^31 cycles from now
+// Outputs: none
+void OSPort_TimerCompare(uint32_t when){
+  WTIMER2_IMR_R = 0x00000000;      // no match while changing it
+  WTIMER2_TAMATCHR_R = when;
+  WTIMER2_ICR_R = 0x00000010;      // clear any old match
+  WTIMER2_IMR_R = 0x00000010;      // arm match interrupt
+  if((int32_t)(when - WTIMER2_TAV_R) <= 0){
+    NVIC_SW_TRIG_R = WTIMER2A_IRQ; // already passed, interrupt now
+  }
+}
+
+// ******** OSPort_TimerCancel ************
+// Disarm the sleep timer interrupt, the timer keeps counting
+// Inputs:  none
+// Outputs: none
+void OSPort_TimerCancel(void){
+  WTIMER2_IMR_R = 0x00000000;
+}
+
+// ******** OSPort_WatchdogInit ************
+// Start Watchdog Timer 0 with reset enabled.  The first time-out
+// only sets its interrupt flag (the interrupt is not enabled in the
+// NVIC), the second one resets, so each time-out is half of timeout
+// Inputs:  bus cycles allowed between feeds
+// Outputs: none
+void OSPort_WatchdogInit(uint32_t timeout){
+  SYSCTL_RCGCWD_R |= 0x01;         // 0) activate clock for Watchdog 0
+  while((SYSCTL_PRWD_R&0x01) == 0){};
+  WATCHDOG0_LOCK_R = WDT_UNLOCK;   // 1) unlock the registers
+  WATCHDOG0_LOAD_R = timeout/2;    // 2) reset after two time-outs
+  WATCHDOG0_TEST_R |= 0x00000100;  // 3) stall while the debugger halts
+  WATCHDOG0_CTL_R |= 0x00000002;   // 4) reset on the second time-out
+  WATCHDOG0_CTL_R |= 0x00000001;   // 5) start counting
+  WATCHDOG0_LOCK_R = 0;            // 6) lock
+}
+
+// ******** OSPort_WatchdogFeed ************
+// Restart the hardware watchdog count
+// Inputs:  none
+// Outputs: none
+void OSPort_WatchdogFeed(void){
+  WATCHDOG0_LOCK_R = WDT_UNLOCK;
+  WATCHDOG0_ICR_R = 0;             // any write reloads and clears the first time-out
+  WATCHDOG0_LOCK_R = 0;
+}
+
+void WideTimer2A_Handler(void){
+  WTIMER2_ICR_R = 0x00000010;      // acknowledge match
+  WakeupHandler();
+}
@@ -0,0 +1,132 @@
+// osport.h
+// Runs on TM4C123 (osport.c and osasm.s) or a Linux host (Host/port)
+// Processor-specific part of the kernel.  Everything in os.c that
+// touches the Cortex-M core goes through these functions, so the
+// scheduler, semaphores, FIFO and sleep code in os.c compile unchanged
+// for the target and for the host port.
+// October 19, 2026
+
+#ifndef __OSPORT_H
+#define __OSPORT_H  1
+
+// Initial stack frame of a thread that has never run.  On the Cortex-M
+// these are the 16 words popped by StartOS or by SysTick_Handler,
+// lowest address first.  The host port only uses pc.
+struct osframe{
+  int32_t r4, r5, r6, r7, r8, r9, r10, r11; // pushed by SysTick_Handler
+  int32_t r0, r1, r2, r3, r12, lr;          // pushed by the exception entry
+  void (*pc)(void);                         // thread starts here
+  int32_t psr;
+};
+typedef struct osframe osFrameType;
+#define OSPORT_FRAMEWORDS (sizeof(osFrameType)/sizeof(int32_t))
+
+// Initializer of the osFrameType of a thread that has never run, the
+// compile-time version of OSPort_InitStack; same register fill values
+#define OSPORT_FRAME(thread) {0x04040404, 0x05050505, 0x06060606, 0x07070707, \
+  0x08080808, 0x09090909, 0x10101010, 0x11111111, 0x00000000, 0x01010101, \
+  0x02020202, 0x03030303, 0x12121212, 0x14141414, (thread), 0x01000000}
+
+// ******** OSPort_InitStack ************
+// Build the initial stack frame of a thread so the first context
+// switch to it starts execution at the beginning of the thread
+// Inputs:  stackEnd, one past the last (highest) word of the stack
+//          thread, pointer to a void/void main thread
+// Outputs: initial stack pointer to store in the TCB
+int32_t *OSPort_InitStack(int32_t *stackEnd, void(*thread)(void));
+
+// ******** OSPort_Launch ************
+// Start the periodic time slice interrupt and run RunPt
+// Inputs:  number of bus cycles in each time slice
+// Outputs: none (does not return)
+// Errors: theTimeSlice must be less than 16,777,216
+void OSPort_Launch(uint32_t theTimeSlice);
+
+// ******** OSPort_Suspend ************
+// Request a context switch; it happens as soon as interrupts are enabled
+// Inputs:  none
+// Outputs: none
+void OSPort_Suspend(void);
+
+// ******** OSPort_SetSlice ************
+// Restart the time slice interrupt so the running thread
+// is preempted after theTimeSlice bus cycles
+// Called by Scheduler from the context switch
+// Inputs:  number of bus cycles until the next time slice interrupt
+// Outputs: none
+// Errors: theTimeSlice must be less than 16,777,216
+void OSPort_SetSlice(uint32_t theTimeSlice);
+
+// ******** OSPort_SliceLeft ************
+// Bus cycles left before the time slice interrupt
+// Inputs:  none
+// Outputs: remaining cycles, at least 1
+uint32_t OSPort_SliceLeft(void);
+
+// ******** OSPort_Idle ************
+// Wait for an interrupt in sleep mode, called by the idle thread
+// with interrupts disabled; returns when an interrupt is pending,
+// without taking it
+// Inputs:  none
+// Outputs: none
+void OSPort_Idle(void);
+
+// ******** OSPort_CycleInit ************
+// Start the free-running cycle counter read by OSPort_Cycles
+// (the Cortex-M4 DWT cycle counter on the target)
+// Inputs:  none
+// Outputs: none
+void OSPort_CycleInit(void);
+
+// ******** OSPort_Cycles ************
+// Read the free-running cycle counter, which counts at the bus clock
+// and wraps every 2^32 cycles (about 53 s at 80 MHz)
+// Inputs:  none
+// Outputs: current count
+uint32_t OSPort_Cycles(void);
+
+// ******** OSPort_TimerInit ************
+// Start the free-running sleep timer read by OSPort_TimerNow.
+// On the TM4C123 this is Wide Timer 2A counting up at the bus
+// clock with its match interrupt at priority 2; the interrupt
+// handler calls WakeupHandler in os.c
+// Inputs:  none
+// Outputs: none
+void OSPort_TimerInit(void);
+
+// ******** OSPort_TimerNow ************
+// Read the sleep timer, which counts bus cycles and wraps every 2^32
+// Inputs:  none
+// Outputs: current count
+uint32_t OSPort_TimerNow(void);
+
+// ******** OSPort_TimerCompare ************
+// Arm the sleep timer interrupt for the time the count reaches when,
+// replacing any earlier setting
+// If when has already passed, the interrupt happens right away
+// Inputs:  when, sleep timer count, less than 2^31 cycles from now
+// Outputs: none
+void OSPort_TimerCompare(uint32_t when);
+
+// ******** OSPort_TimerCancel ************
+// Disarm the sleep timer interrupt, the timer keeps counting
+// Inputs:  none
+// Outputs: none
+void OSPort_TimerCancel(void);
+
+// ******** OSPort_WatchdogInit ************
+// Start the hardware watchdog, which resets the processor unless
+// OSPort_WatchdogFeed is called at least every timeout bus cycles.
+// On the TM4C123 this is Watchdog Timer 0, stalled while the
+// debugger has the processor halted
+// Inputs:  bus cycles allowed between feeds
+// Outputs: none
+void OSPort_WatchdogInit(uint32_t timeout);
+
+// ******** OSPort_WatchdogFeed ************
+// Restart the hardware watchdog count
+// Inputs:  none
+// Outputs: none
+void OSPort_WatchdogFeed(void);
+
+#endif
@@ -39,6 +39,8 @@
 #include <stdint.h>
 #include "../inc/BSP.h"
 #include "../inc/CortexM.h"
+#include "../inc/RunStats.h"
+#include "../inc/StepDetect.h"
 #include "../inc/UART0.h"
 #include "../inc/Profile.h"
 #include "os.h"
@@ -47,7 +49,6 @@
 #include "AP_Lab6.h"
 
 
-uint32_t sqrt32(uint32_t s);
 #define THREADFREQ 1000   // frequency in Hz of round robin scheduler
 
 //---------------- Global variables shared between tasks ----------------
@@ -91,8 +92,8 @@ enum plotstate PlotState = Accelerometer;
 
 //---------------- Task0 samples sound from microphone ----------------
 // Event thread run by OS in real time at 1000 Hz
-#define SOUNDRMSLENGTH 1000 // number of samples to collect before calculating RMS (may overflow if greater than 4104)
-int16_t SoundArray[SOUNDRMSLENGTH];
+#define SOUNDRMSLENGTH 1000 // number of samples in each RMS, up to 65536
+runStatsType Sound;         // running sums of the samples so far, see RunStats.h
 // *********Task0_Init*********
 // initializes microphone
 // Task0 measures sound intensity
@@ -100,6 +101,7 @@ int16_t SoundArray[SOUNDRMSLENGTH];
 // Outputs: none
 void Task0_Init(void){
   BSP_Microphone_Init();
+  RunStats_Init(&Sound, 0, 0);  // running total, reset every SOUNDRMSLENGTH
   SoundRMS = 0;
 }
 // *********Task0*********
@@ -108,20 +110,15 @@ void Task0_Init(void){
 // Inputs:  none
 // Outputs: none
 void Task0(void){
-  static int32_t soundSum = 0;
-  static int time = 0;// units of microphone sampling rate
-
   TExaS_Task0();     // record system time in array, toggle virtual logic analyzer
   Profile_Toggle0(); // viewed by a real logic analyzer to know Task0 started
   BSP_Microphone_Input(&SoundData);
-  soundSum = soundSum + (int32_t)SoundData;
-  SoundArray[time] = SoundData;
-  time = time + 1;
-  if(time == SOUNDRMSLENGTH){
-    SoundAvg = soundSum/SOUNDRMSLENGTH;
-    soundSum = 0;
+  RunStats_Put(&Sound, SoundData);
+  if(Sound.count == SOUNDRMSLENGTH){
+    SoundAvg = RunStats_Mean(&Sound);
+    SoundRMS = RunStats_RMS(&Sound);
+    RunStats_Reset(&Sound);
     OS_Signal(&NewData); // makes task5 run every 1 sec
-    time = 0;
   }
 }
 /* ****************************************** */
@@ -132,18 +129,7 @@ void Task0(void){
 // Event thread run by OS in real time at 10 Hz
 uint32_t LostTask1Data;     // number of times that the FIFO was full when acceleration data was ready
 uint16_t AccX, AccY, AccZ;  // returned by BSP as 10-bit numbers
-#define ALPHA 128           // The degree of weighting decrease, a constant smoothing factor between 0 and 1,023. A higher ALPHA discounts older observations faster.
-                            // basic step counting algorithm is based on a forum post from
-                            // http://stackoverflow.com/questions/16392142/android-accelerometer-profiling/16539643#16539643
-enum state{                 // the step counting algorithm cycles through four states
-  LookingForMax,            // looking for a local maximum in current magnitude
-  LookingForCross1,         // looking for current magnitude to cross average magnitude, minus a constant
-  LookingForMin,            // looking for a local minimum in current magnitude
-  LookingForCross2          // looking for current magnitude to cross average magnitude, plus a constant
-};
-enum state AlgorithmState = LookingForMax;
-#define LOCALCOUNTTARGET 5  // The number of valid measured magnitudes needed to confirm a local min or local max.  Increase this number for longer strides or more frequent measurements.
-#define AVGOVERSHOOT 25     // The amount above or below average a measurement must be to count as "crossing" the average.  Increase this number to reject increasingly hard shaking as steps.
+stepDetectType StepDetector; // step counter, see StepDetect.h for the algorithm and its parameters
 // *********Task1_Init*********
 // initializes accelerometer
 // Task1 counts Steps
@@ -153,8 +139,9 @@ void Task1_Init(void){
   BSP_Accelerometer_Init();
   // initialize the exponential weighted moving average filter
   BSP_Accelerometer_Input(&AccX, &AccY, &AccZ);
-  Magnitude = sqrt32(AccX*AccX + AccY*AccY + AccZ*AccZ);
-  EWMA = Magnitude;                // this is a guess; there are many options
+  StepDetect_Init(&StepDetector, STEP_MAGNITUDE, AccX*AccX + AccY*AccY + AccZ*AccZ);
+  Magnitude = StepDetect_Magnitude(&StepDetector);
+  EWMA = StepDetect_Average(&StepDetector);
   Steps = 0;
   LostTask1Data = 0;
 }
@@ -204,12 +191,6 @@ void drawaxes(void){
   OS_Signal(&LCDmutex);  ReDrawAxes = 0;
 }
 void Task2(void){uint32_t data;
-  uint32_t localMin;   // smallest measured magnitude since odd-numbered step detected
-  uint32_t localMax;   // largest measured magnitude since even-numbered step detected
-  uint32_t localCount; // number of measured magnitudes above local min or below local max
-  localMin = 1024;
-  localMax = 0;
-  localCount = 0;
   drawaxes();
   while(1){
 
@@ -217,55 +198,10 @@ void Task2(void){uint32_t data;
     data = OS_FIFO_Get();
     TExaS_Task2();     // records system time in array, toggles virtual logic analyzer
     Profile_Toggle2(); // viewed by a real logic analyzer to know Task2 started
-    Magnitude = sqrt32(data);
-    EWMA = (ALPHA*Magnitude + (1023 - ALPHA)*EWMA)/1024;
-    if(AlgorithmState == LookingForMax){
-      if(Magnitude > localMax){
-        localMax = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross1;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross1){
-      if(Magnitude > localMax){
-      // somehow measured a very large magnitude
-        localMax = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      } else if(Magnitude < (EWMA -  AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMin = 1024;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      }
-    } else if(AlgorithmState == LookingForMin){
-      if(Magnitude < localMin){
-        localMin = Magnitude;
-        localCount = 0;
-      } else{
-        localCount = localCount + 1;
-        if(localCount >= LOCALCOUNTTARGET){
-          AlgorithmState = LookingForCross2;
-        }
-      }
-    } else if(AlgorithmState == LookingForCross2){
-      if(Magnitude < localMin){
-      // somehow measured a very small magnitude
-        localMin = Magnitude;
-        localCount = 0;
-        AlgorithmState = LookingForMin;
-      } else if(Magnitude > (EWMA + AVGOVERSHOOT)){
-        // step detected
-        Steps = Steps + 1;
-        localMax = 0;
-        localCount = 0;
-        AlgorithmState = LookingForMax;
-      }
-    }
+    StepDetect_Put(&StepDetector, data);
+    Steps = StepDetector.steps;
+    Magnitude = StepDetect_Magnitude(&StepDetector);
+    EWMA = StepDetect_Average(&StepDetector);
     if(ReDrawAxes){
       drawaxes();
       ReDrawAxes = 0;
@@ -337,7 +273,7 @@ void Task3(void){
     }
     prev2 = current;
     // update the LED
-    switch(AlgorithmState){
+    switch(StepDetector.state){
       case LookingForMax: BSP_RGB_Set(500, 0, 0); break;
       case LookingForCross1: BSP_RGB_Set(350, 350, 0); break;
       case LookingForMin: BSP_RGB_Set(0, 500, 0); break;
@@ -392,7 +328,7 @@ void Task4(void){int32_t voltData,tempData;
 // updates the text at the top and bottom of the LCD
 // Inputs:  none
 // Outputs: none
-void Task5(void){int32_t soundSum; int count=0;
+void Task5(void){int count=0;
   OS_Wait(&LCDmutex);
   BSP_LCD_DrawString(0,  0, "Temp=",  TOPTXTCOLOR);
   BSP_LCD_DrawString(0,  1, "Step=",  TOPTXTCOLOR);
@@ -403,11 +339,6 @@ void Task5(void){int32_t soundSum; int count=0;
     OS_Wait(&NewData);
     TExaS_Task5();     // records system time in array, toggles virtual logic analyzer
 //    Profile_Toggle5(); // viewed by a real logic analyzer to know Task5 started
-    soundSum = 0;
-    for(int i=0; i<SOUNDRMSLENGTH; i=i+1){
-      soundSum = soundSum + (SoundArray[i] - SoundAvg)*(SoundArray[i] - SoundAvg);
-    }
-    SoundRMS = sqrt32(soundSum/SOUNDRMSLENGTH);
     OS_Wait(&LCDmutex);
     BSP_LCD_SetCursor(5,  0); BSP_LCD_OutUFix2_1(TemperatureData, TEMPCOLOR);
     BSP_LCD_SetCursor(5,  1); BSP_LCD_OutUDec4(Steps,             MAGCOLOR);
@@ -594,16 +525,3 @@ int main(void){
 /* ****************************************** */
 /*          End of Step 6 Section             */
 /* ****************************************** */
-
-// Newton's method
-// s is an integer
-// sqrt(s) is an integer
-uint32_t sqrt32(uint32_t s){
-uint32_t t;   // t*t will become s
-int n;             // loop counter
-  t = s/16+1;      // initial guess
-  for(n = 16; n; --n){ // will finish
-    t = ((t*t+s)/t)/2;
-  }
-  return t;
-}
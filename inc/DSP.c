@@ -0,0 +1,145 @@
+// DSP.c
+// Runs on TM4C123
+// Fixed-point block kernels, see DSP.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "DSP.h"
+
+// SMLAD:  acc + x.lo*y.lo + x.hi*y.hi, 32-bit accumulator
+// SMLALD: the same with a 64-bit accumulator
+#if defined(__ARMCC_VERSION) && defined(__TARGET_FEATURE_DSPMUL)
+#define DSPSIMD 1
+#define SMLAD(x, y, acc)  __smlad(x, y, acc)
+#define SMLALD(x, y, acc) __smlald(x, y, acc)
+#elif defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+#define DSPSIMD 1
+static __inline uint32_t SMLAD(uint32_t x, uint32_t y, uint32_t acc){
+  uint32_t r;
+  __asm volatile("smlad %0, %1, %2, %3" : "=r"(r) : "r"(x), "r"(y), "r"(acc));
+  return r;
+}
+static __inline uint64_t SMLALD(uint32_t x, uint32_t y, uint64_t acc){
+  uint32_t lo = (uint32_t)acc, hi = (uint32_t)(acc>>32);
+  __asm volatile("smlald %0, %1, %2, %3" : "+r"(lo), "+r"(hi) : "r"(x), "r"(y));
+  return ((uint64_t)hi<<32)|lo;
+}
+#else
+#define DSPSIMD 0
+#endif
+
+#if DSPSIMD
+#define ALIGNED(p) ((((uint32_t)(p))&3) == 0)
+#endif
+
+// ******** DSP_Sum ************
+// Sum of a block
+// Inputs:  x, n samples
+// Outputs: sum
+int32_t DSP_Sum(const int16_t *x, uint32_t n){
+  int32_t sum = 0;
+#if DSPSIMD
+  if(ALIGNED(x)){
+    const uint32_t *pt = (const uint32_t *)x;
+    uint32_t acc = 0;
+    for(; n>=4; n=n-4){             // 1*lo + 1*hi
+      acc = SMLAD(*pt++, 0x00010001, acc);
+      acc = SMLAD(*pt++, 0x00010001, acc);
+    }
+    sum = (int32_t)acc;
+    x = (const int16_t *)pt;
+  }
+#endif
+  while(n){
+    sum = sum + *x++;
+    n--;
+  }
+  return sum;
+}
+
+// ******** DSP_SumSq ************
+// Sum of the squares of a block
+// Inputs:  x, n samples
+// Outputs: sum of squares
+uint64_t DSP_SumSq(const int16_t *x, uint32_t n){
+  uint64_t sum = 0;
+  int32_t s;
+#if DSPSIMD
+  if(ALIGNED(x)){
+    const uint32_t *pt = (const uint32_t *)x;
+    uint32_t pair;
+    for(; n>=4; n=n-4){
+      pair = *pt++;
+      sum = SMLALD(pair, pair, sum);
+      pair = *pt++;
+      sum = SMLALD(pair, pair, sum);
+    }
+    x = (const int16_t *)pt;
+  }
+#endif
+  while(n){
+    s = *x++;
+    sum = sum + (uint32_t)(s*s);
+    n--;
+  }
+  return sum;
+}
+
+// ******** DSP_Dot ************
+// Dot product of two blocks
+// Inputs:  x, y, n samples each
+// Outputs: dot product
+int64_t DSP_Dot(const int16_t *x, const int16_t *y, uint32_t n){
+  int64_t sum = 0;
+#if DSPSIMD
+  if(ALIGNED(x)&&ALIGNED(y)){
+    const uint32_t *px = (const uint32_t *)x;
+    const uint32_t *py = (const uint32_t *)y;
+    uint64_t acc = 0;
+    for(; n>=4; n=n-4){
+      acc = SMLALD(*px++, *py++, acc);
+      acc = SMLALD(*px++, *py++, acc);
+    }
+    sum = (int64_t)acc;
+    x = (const int16_t *)px;
+    y = (const int16_t *)py;
+  }
+#endif
+  while(n){
+    sum = sum + (int32_t)(*x++)*(*y++);
+    n--;
+  }
+  return sum;
+}
+
+// ******** DSP_MinMax ************
+// Smallest and largest sample of a block, two samples per pass
+// (the SIMD form needs the GE flags from SSUB16 to reach SEL, which
+// C cannot guarantee between intrinsics)
+// Inputs:  x, n samples, n at least 1
+//          min, max, where to store the results
+// Outputs: none
+void DSP_MinMax(const int16_t *x, uint32_t n, int16_t *min, int16_t *max){
+  int32_t lo = *x, hi = *x;
+  int32_t a, b;
+  x++;
+  n--;
+  for(; n>=2; n=n-2){
+    a = x[0];
+    b = x[1];
+    x = x + 2;
+    if(a > b){                      // 3 compares per 2 samples
+      if(a > hi) hi = a;
+      if(b < lo) lo = b;
+    } else{
+      if(b > hi) hi = b;
+      if(a < lo) lo = a;
+    }
+  }
+  if(n){
+    if(*x > hi) hi = *x;
+    if(*x < lo) lo = *x;
+  }
+  *min = lo;
+  *max = hi;
+}
@@ -0,0 +1,42 @@
+// DSP.h
+// Runs on TM4C123
+// Fixed-point kernels over blocks of 16-bit samples: sum, sum of
+// squares, dot product and minimum/maximum.  On a Cortex-M4 the sum,
+// sum of squares and dot product read two samples per 32-bit load and
+// use the dual 16-bit multiply-accumulate instructions SMLAD and
+// SMLALD, two samples per instruction.  Elsewhere (the Host build, or
+// a core without the DSP extension) they are plain C with the same
+// results.
+// The two-sample path needs the arrays 4-byte aligned; other arrays
+// take the C path.
+// October 19, 2026
+
+#ifndef __DSP_H
+#define __DSP_H  1
+
+// ******** DSP_Sum ************
+// Sum of a block
+// Inputs:  x, n samples, n at most 65536
+// Outputs: x[0]+x[1]+...+x[n-1]
+int32_t DSP_Sum(const int16_t *x, uint32_t n);
+
+// ******** DSP_SumSq ************
+// Sum of the squares of a block
+// Inputs:  x, n samples
+// Outputs: x[0]^2+x[1]^2+...+x[n-1]^2
+uint64_t DSP_SumSq(const int16_t *x, uint32_t n);
+
+// ******** DSP_Dot ************
+// Dot product of two blocks
+// Inputs:  x, y, n samples each
+// Outputs: x[0]*y[0]+x[1]*y[1]+...+x[n-1]*y[n-1]
+int64_t DSP_Dot(const int16_t *x, const int16_t *y, uint32_t n);
+
+// ******** DSP_MinMax ************
+// Smallest and largest sample of a block
+// Inputs:  x, n samples, n at least 1
+//          min, max, where to store the results
+// Outputs: none
+void DSP_MinMax(const int16_t *x, uint32_t n, int16_t *min, int16_t *max);
+
+#endif
@@ -0,0 +1,95 @@
+// RunStats.c
+// Runs on TM4C123
+// Streaming mean, variance and RMS, see RunStats.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "RunStats.h"
+#include "Sqrt.h"
+
+// ******** RunStats_Init ************
+// Start with no samples
+// Inputs:  pt, statistics
+//          window, array of size samples, or 0 for a running total
+//          size, samples in the sliding window
+// Outputs: none
+void RunStats_Init(runStatsType *pt, int16_t *window, uint32_t size){
+  pt->window = window;
+  pt->size = size;
+  RunStats_Reset(pt);
+}
+
+// ******** RunStats_Reset ************
+// Forget all samples
+// Inputs:  pt, statistics
+// Outputs: none
+void RunStats_Reset(runStatsType *pt){
+  pt->index = 0;
+  pt->count = 0;
+  pt->sum = 0;
+  pt->sumSq = 0;
+}
+
+// ******** RunStats_Put ************
+// Add one sample, dropping the oldest once a sliding window is full
+// Inputs:  pt, statistics
+//          x, new sample
+// Outputs: none
+void RunStats_Put(runStatsType *pt, int16_t x){
+  int32_t old;
+  if(pt->window){
+    if(pt->count == pt->size){
+      old = pt->window[pt->index];
+      pt->sum -= old;
+      pt->sumSq -= (uint32_t)(old*old);
+    } else{
+      pt->count++;
+    }
+    pt->window[pt->index] = x;
+    pt->index++;
+    if(pt->index == pt->size){
+      pt->index = 0;
+    }
+  } else{
+    pt->count++;
+  }
+  pt->sum += x;
+  pt->sumSq += (uint32_t)(x*x);
+}
+
+// ******** RunStats_Mean ************
+// Mean of the samples, rounded toward zero
+// Inputs:  pt, statistics
+// Outputs: mean, 0 if there are no samples
+int32_t RunStats_Mean(runStatsType *pt){
+  if(pt->count == 0){
+    return 0;
+  }
+  return (int32_t)(pt->sum/(int32_t)pt->count);
+}
+
+// ******** RunStats_Variance ************
+// Population variance, n*variance = sumSq - sum*sum/n
+// Inputs:  pt, statistics
+// Outputs: variance, 0 if there are no samples
+uint32_t RunStats_Variance(runStatsType *pt){
+  uint64_t sum2;
+  if(pt->count == 0){
+    return 0;
+  }
+  if(pt->sum < 0){
+    sum2 = (uint64_t)(-pt->sum);
+  } else{
+    sum2 = (uint64_t)pt->sum;
+  }
+  sum2 = sum2*sum2/pt->count;   // |sum| < 2^31, no overflow
+  return (uint32_t)((pt->sumSq - sum2)/pt->count);
+}
+
+// ******** RunStats_RMS ************
+// RMS about the mean of the samples
+// Inputs:  pt, statistics
+// Outputs: RMS, 0 if there are no samples
+uint32_t RunStats_RMS(runStatsType *pt){
+  return sqrt32(RunStats_Variance(pt));
+}
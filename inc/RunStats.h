@@ -0,0 +1,67 @@
+// RunStats.h
+// Runs on TM4C123
+// Streaming mean, variance and RMS of 16-bit samples, updated in
+// constant time per sample, so no second pass over stored samples is
+// needed and the result can be read at any instant.  The sums are
+// exact 64-bit integers, so there is no rounding to correct for
+// (Welford's method is only needed with floating point).
+// Two modes:
+//   running total  no storage; RunStats_Reset starts the next block
+//   sliding window the last size samples, kept in a caller's array
+// October 19, 2026
+
+#ifndef __RUNSTATS_H
+#define __RUNSTATS_H  1
+
+struct runstats{
+  int16_t *window;        // last size samples, 0 for a running total
+  uint32_t size;          // entries of window[]
+  uint32_t index;         // next entry of window[] to replace
+  uint32_t count;         // samples in the sums
+  int64_t sum;            // sum of the samples
+  uint64_t sumSq;         // sum of the squares of the samples
+};
+typedef struct runstats runStatsType;
+
+// ******** RunStats_Init ************
+// Start with no samples
+// Inputs:  pt, statistics
+//          window, array of size samples for a sliding window,
+//            or 0 for a running total
+//          size, samples in the sliding window, 1 to 65536
+// Outputs: none
+void RunStats_Init(runStatsType *pt, int16_t *window, uint32_t size);
+
+// ******** RunStats_Reset ************
+// Forget all samples, for example at the end of a block
+// Inputs:  pt, statistics
+// Outputs: none
+void RunStats_Reset(runStatsType *pt);
+
+// ******** RunStats_Put ************
+// Add one sample, dropping the oldest once a sliding window is full
+// Inputs:  pt, statistics
+//          x, new sample
+// Outputs: none
+void RunStats_Put(runStatsType *pt, int16_t x);
+
+// ******** RunStats_Mean ************
+// Mean of the samples, rounded toward zero
+// Inputs:  pt, statistics
+// Outputs: mean, 0 if there are no samples
+int32_t RunStats_Mean(runStatsType *pt);
+
+// ******** RunStats_Variance ************
+// Population variance of the samples, exact to within one count
+// while there are at most 65536 samples
+// Inputs:  pt, statistics
+// Outputs: variance, 0 if there are no samples
+uint32_t RunStats_Variance(runStatsType *pt);
+
+// ******** RunStats_RMS ************
+// RMS about the mean (standard deviation) of the samples
+// Inputs:  pt, statistics
+// Outputs: RMS, 0 if there are no samples
+uint32_t RunStats_RMS(runStatsType *pt);
+
+#endif
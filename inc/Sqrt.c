@@ -0,0 +1,44 @@
+// Sqrt.c
+// Runs on TM4C123
+// Integer square root, see Sqrt.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "Sqrt.h"
+
+#if defined(__ARMCC_VERSION)
+#define CLZ(x) __clz(x)
+#elif defined(__GNUC__)
+#define CLZ(x) __builtin_clz(x)
+#else
+static uint32_t CLZ(uint32_t x){uint32_t n = 0;
+  while((x&0x80000000) == 0){
+    x = x<<1;
+    n++;
+  }
+  return n;
+}
+#endif
+
+// ******** sqrt32 ************
+// Integer square root
+// Inputs:  s, any 32-bit number
+// Outputs: largest t with t*t <= s
+uint32_t sqrt32(uint32_t s){
+  uint32_t root = 0;   // result bits so far, scaled up by bit
+  uint32_t bit;        // power of 4 for the next result bit
+  if(s == 0){
+    return 0;
+  }
+  bit = 1u<<((31 - CLZ(s))&~1u); // highest power of 4 <= s
+  while(bit){
+    if(s >= root + bit){
+      s = s - (root + bit);
+      root = (root>>1) + bit;
+    } else{
+      root = root>>1;
+    }
+    bit = bit>>2;
+  }
+  return root;
+}
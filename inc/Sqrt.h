@@ -0,0 +1,20 @@
+// Sqrt.h
+// Runs on TM4C123
+// Integer square root shared by the labs, in place of the Newton's
+// method sqrt32 each lab used to carry.  Digit by digit: one result bit
+// per step, at most 16 steps of shifts, adds and compares and no
+// division, starting at the highest set bit of s found with CLZ, so
+// small arguments take fewer steps.  The result is exactly
+// floor(sqrt(s)) for every 32-bit s, including 0.
+// October 19, 2026
+
+#ifndef __SQRT_H
+#define __SQRT_H  1
+
+// ******** sqrt32 ************
+// Integer square root
+// Inputs:  s, any 32-bit number
+// Outputs: largest t with t*t <= s
+uint32_t sqrt32(uint32_t s);
+
+#endif
@@ -0,0 +1,125 @@
+// StepDetect.c
+// Runs on TM4C123
+// Four-state step counter, see StepDetect.h.
+// October 19, 2026
+
+#include <stdint.h>
+#include "StepDetect.h"
+#include "Sqrt.h"
+
+// starting local minimum, as in the lab code
+#define LOCALMIN(pt) (((pt)->mode == STEP_SQUARED)? 1024*1024 : 1024)
+
+// ******** StepDetect_Init ************
+// Set the default parameters for the mode, no steps yet
+// Inputs:  pt, detector
+//          mode, STEP_MAGNITUDE or STEP_SQUARED
+//          squared, a first x*x+y*y+z*z to start the average at
+// Outputs: none
+void StepDetect_Init(stepDetectType *pt, uint32_t mode, uint32_t squared){
+  pt->alpha = STEP_ALPHA;
+  pt->localCountTarget = STEP_LOCALCOUNTTARGET;
+  pt->mode = mode;
+  if(mode == STEP_SQUARED){
+    pt->overshoot = STEP_AVGOVERSHOOTSQ;
+    pt->value = squared;
+  } else{
+    pt->overshoot = STEP_AVGOVERSHOOT;
+    pt->value = sqrt32(squared);
+  }
+  pt->average = pt->value;  // this is a guess; there are many options
+  pt->state = LookingForMax;
+  pt->localMin = LOCALMIN(pt);
+  pt->localMax = 0;
+  pt->localCount = 0;
+  pt->steps = 0;
+}
+
+// ******** StepDetect_Put ************
+// Run the detector on one accelerometer sample
+// Inputs:  pt, detector
+//          squared, x*x+y*y+z*z
+// Outputs: 1 if this sample completed a step, 0 if not
+int StepDetect_Put(stepDetectType *pt, uint32_t squared){
+  uint32_t value;
+  int step = 0;
+  if(pt->mode == STEP_SQUARED){
+    value = squared;
+  } else{
+    value = sqrt32(squared);
+  }
+  pt->value = value;
+  // (alpha*value + (1023-alpha)*average)/1024, in 64 bits for squared values
+  pt->average = (uint32_t)(((uint64_t)pt->alpha*value + (uint64_t)(1023 - pt->alpha)*pt->average)/1024);
+  if(pt->state == LookingForMax){
+    if(value > pt->localMax){
+      pt->localMax = value;
+      pt->localCount = 0;
+    } else{
+      pt->localCount = pt->localCount + 1;
+      if(pt->localCount >= pt->localCountTarget){
+        pt->state = LookingForCross1;
+      }
+    }
+  } else if(pt->state == LookingForCross1){
+    if(value > pt->localMax){
+      // somehow measured a very large magnitude
+      pt->localMax = value;
+      pt->localCount = 0;
+      pt->state = LookingForMax;
+    } else if(value + pt->overshoot < pt->average){
+      // step detected
+      step = 1;
+      pt->localMin = LOCALMIN(pt);
+      pt->localCount = 0;
+      pt->state = LookingForMin;
+    }
+  } else if(pt->state == LookingForMin){
+    if(value < pt->localMin){
+      pt->localMin = value;
+      pt->localCount = 0;
+    } else{
+      pt->localCount = pt->localCount + 1;
+      if(pt->localCount >= pt->localCountTarget){
+        pt->state = LookingForCross2;
+      }
+    }
+  } else if(pt->state == LookingForCross2){
+    if(value < pt->localMin){
+      // somehow measured a very small magnitude
+      pt->localMin = value;
+      pt->localCount = 0;
+      pt->state = LookingForMin;
+    } else if(value > pt->average + pt->overshoot){
+      // step detected
+      step = 1;
+      pt->localMax = 0;
+      pt->localCount = 0;
+      pt->state = LookingForMax;
+    }
+  }
+  pt->steps = pt->steps + step;
+  return step;
+}
+
+// ******** StepDetect_Magnitude ************
+// Last magnitude, for display
+// Inputs:  pt, detector
+// Outputs: magnitude
+uint32_t StepDetect_Magnitude(stepDetectType *pt){
+  if(pt->mode == STEP_SQUARED){
+    return sqrt32(pt->value);
+  }
+  return pt->value;
+}
+
+// ******** StepDetect_Average ************
+// Average magnitude, for display
+// Inputs:  pt, detector
+// Outputs: EWMA of the magnitude
+uint32_t StepDetect_Average(stepDetectType *pt){
+  if(pt->mode == STEP_SQUARED){
+    return sqrt32(pt->average);
+  }
+  return pt->average;
+}
@@ -0,0 +1,79 @@
+// StepDetect.h
+// Runs on TM4C123
+// Step counter on accelerometer magnitudes, one object per detector,
+// so several can run at once (for example two settings side by side,
+// or the host replay in Host/stepreplay.c) and the parameters can be
+// changed while it runs.
+// The basic step counting algorithm is based on a forum post from
+// http://stackoverflow.com/questions/16392142/android-accelerometer-profiling/16539643#16539643
+// It cycles through four states: find a local maximum, wait for the
+// magnitude to fall below the average minus an overshoot (a step),
+// find a local minimum, wait for the magnitude to rise above the
+// average plus the overshoot (a step).  The average is an exponentially
+// weighted moving average (EWMA).
+// October 19, 2026
+
+#ifndef __STEPDETECT_H
+#define __STEPDETECT_H  1
+
+#define STEP_MAGNITUDE 0    // works on sqrt32 of the squared magnitude
+#define STEP_SQUARED   1    // works on the squared magnitude, no sqrt32 per sample
+
+// defaults set by StepDetect_Init
+#define STEP_ALPHA 128            // The degree of weighting decrease, a constant smoothing factor between 0 and 1,023. A higher alpha discounts older observations faster.
+#define STEP_LOCALCOUNTTARGET 5   // The number of valid measured magnitudes needed to confirm a local min or local max.  Increase this number for longer strides or more frequent measurements.
+#define STEP_AVGOVERSHOOT 25      // The amount above or below average a measurement must be to count as "crossing" the average.  Increase this number to reject increasingly hard shaking as steps.
+#define STEP_AVGOVERSHOOTSQ 45000 // STEP_AVGOVERSHOOT in squared units, 2*25*900 for magnitudes near 900
+
+enum stepstate{             // the step counting algorithm cycles through four states
+  LookingForMax,            // looking for a local maximum in current magnitude
+  LookingForCross1,         // looking for current magnitude to cross average magnitude, minus a constant
+  LookingForMin,            // looking for a local minimum in current magnitude
+  LookingForCross2          // looking for current magnitude to cross average magnitude, plus a constant
+};
+
+struct stepdetect{
+  // parameters, may be changed between calls to StepDetect_Put
+  uint32_t alpha;           // weight of a new value in the average, 0 to 1023 of 1024
+  uint32_t localCountTarget;// values needed to confirm a local min or max
+  uint32_t overshoot;       // crossing margin, in the units of value
+  uint32_t mode;            // STEP_MAGNITUDE or STEP_SQUARED
+  // state
+  enum stepstate state;
+  uint32_t value;           // last magnitude, or squared magnitude in STEP_SQUARED
+  uint32_t average;         // EWMA of value
+  uint32_t localMin;        // smallest value since odd-numbered step detected
+  uint32_t localMax;        // largest value since even-numbered step detected
+  uint32_t localCount;      // values above local min or below local max
+  uint32_t steps;           // steps counted
+};
+typedef struct stepdetect stepDetectType;
+
+// ******** StepDetect_Init ************
+// Set the default parameters for the mode, no steps yet
+// Inputs:  pt, detector
+//          mode, STEP_MAGNITUDE or STEP_SQUARED
+//          squared, a first x*x+y*y+z*z to start the average at
+// Outputs: none
+void StepDetect_Init(stepDetectType *pt, uint32_t mode, uint32_t squared);
+
+// ******** StepDetect_Put ************
+// Run the detector on one accelerometer sample
+// Inputs:  pt, detector
+//          squared, x*x+y*y+z*z, at most 3*1023^2 for 10-bit axes
+// Outputs: 1 if this sample completed a step, 0 if not
+int StepDetect_Put(stepDetectType *pt, uint32_t squared);
+
+// ******** StepDetect_Magnitude ************
+// Last magnitude, for display; calls sqrt32 in STEP_SQUARED
+// Inputs:  pt, detector
+// Outputs: magnitude
+uint32_t StepDetect_Magnitude(stepDetectType *pt);
+
+// ******** StepDetect_Average ************
+// Average magnitude, for display; calls sqrt32 in STEP_SQUARED
+// Inputs:  pt, detector
+// Outputs: EWMA of the magnitude (root of the EWMA of the squares in STEP_SQUARED)
+uint32_t StepDetect_Average(stepDetectType *pt);
+
+#endif